@@ -3,28 +3,67 @@
 namespace s21 {
 
 void Controller::LoadModel(const std::string& file_path) {
-  model_->CountVerticesAndFacets(file_path);
-  model_->ParseModelData(file_path);
+  journal.Clear();
+  model_->LoadModelData(file_path);
+}
+
+LoadSettings Controller::GetLoadSettings() const {
+  LoadSettings settings;
+  settings.load_mode = model_->GetLoadMode();
+  settings.load_threads = model_->GetLoadThreads();
+  settings.cache_enabled = model_->GetCacheEnabled();
+  settings.cache_directory = model_->GetCacheDirectory();
+  settings.cleanup_enabled = model_->GetCleanupEnabled();
+  settings.weld_epsilon = model_->GetWeldEpsilon();
+  settings.vertex_storage = model_->GetVertexStorage();
+  settings.adjacency_enabled = model_->GetAdjacencyEnabled();
+  return settings;
+}
+
+std::shared_ptr<Model> Controller::PrepareModel(const std::string& file_path,
+                                                const LoadSettings& settings,
+                                                LoadControl control) {
+  auto model = std::make_shared<Model>();
+  model->SetLoadMode(settings.load_mode);
+  model->SetLoadThreads(settings.load_threads);
+  model->SetCacheEnabled(settings.cache_enabled);
+  model->SetCacheDirectory(settings.cache_directory);
+  model->SetCleanupEnabled(settings.cleanup_enabled);
+  model->SetWeldEpsilon(settings.weld_epsilon);
+  model->SetVertexStorage(settings.vertex_storage);
+  model->SetAdjacencyEnabled(settings.adjacency_enabled);
+  model->SetLoadControl(std::move(control));
+  model->LoadModelData(file_path);
+  model->SetLoadControl(LoadControl());
+  model->NormalizeModel(1.0);
+  return model;
 }
 
 void Controller::RotateModel(double step, char xyz) {
-  RotateCommand cmd(model_, step, xyz);
-  cmd.execute();
+  journal.Execute(std::make_unique<RotateCommand>(model_, step, xyz));
 }
 
 void Controller::ApplyRotation() { model_->ApplyRotation(); }
 
 void Controller::MoveModel(double distance, char xyz) {
-  MoveCommand cmd(model_, distance, xyz);
-  cmd.execute();
+  journal.Execute(std::make_unique<MoveCommand>(model_, distance, xyz));
 }
 
-void Controller::CenterModel() { model_->CenterModel(); }
+void Controller::DragModel(double x_step, double y_step) {
+  journal.Execute(std::make_unique<DragCommand>(model_, x_step, y_step));
+}
+
+void Controller::CenterModel() {
+  journal.Execute(std::make_unique<CenterCommand>(model_));
+}
 
 void Controller::ScaleModelToFit(double scale_factor) {
-  model_->ScaleModelToFit(scale_factor);
+  journal.Execute(std::make_unique<ScaleCommand>(model_, scale_factor));
 }
 
-void Controller::ClearModelData() { model_->ClearData(); }
+void Controller::ClearModelData() {
+  journal.Clear();
+  model_->ClearData();
+}
 
 }  // namespace s21
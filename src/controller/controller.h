@@ -1,6 +1,7 @@
 #ifndef CPP4_S21_3DVIEWER_V2_SRC_CONTROLLER_CONTROLLER_H
 #define CPP4_S21_3DVIEWER_V2_SRC_CONTROLLER_CONTROLLER_H
 
+#include <memory>
 #include <stdexcept>
 #include <string>
 
@@ -9,6 +10,19 @@
 
 namespace s21 {
 
+// Настройки загрузки текущей модели. Снимаются в потоке интерфейса, чтобы
+// фоновая загрузка не читала модель, которую может заменить CommitModel.
+struct LoadSettings {
+  LoadMode load_mode;
+  unsigned load_threads;
+  bool cache_enabled;
+  std::string cache_directory;
+  bool cleanup_enabled;
+  double weld_epsilon;
+  VertexStorage vertex_storage;
+  bool adjacency_enabled;
+};
+
 class Controller {
  public:
   static Controller& getInstance(Model* model = nullptr) {
@@ -17,22 +31,75 @@ class Controller {
   }
 
   void LoadModel(const std::string& file_path);
+  LoadSettings GetLoadSettings() const;
+  static std::shared_ptr<Model> PrepareModel(const std::string& file_path,
+                                             const LoadSettings& settings,
+                                             LoadControl control);
+  void CommitModel(Model&& model) {
+    *model_ = std::move(model);
+    journal.Clear();
+  }
   void RotateModel(double step, char xyz);
   void ApplyRotation();
   void MoveModel(double distance, char xyz);
+  // Поворот мышью; между BeginDrag и EndDrag сливается в одну запись
+  void DragModel(double x_step, double y_step);
   void CenterModel();
   void ScaleModelToFit(double scale_factor);
   void ClearModelData();
+  // Отмена и повтор преобразований; поворот мышью отменяется целиком.
+  bool Undo() { return journal.Undo(); }
+  bool Redo() { return journal.Redo(); }
+  bool CanUndo() const { return journal.CanUndo(); }
+  bool CanRedo() const { return journal.CanRedo(); }
+  void BeginDrag() { journal.BeginCoalescing(); }
+  void EndDrag() { journal.EndCoalescing(); }
+  const LoadStats& GetLoadStats() const { return model_->GetLoadStats(); }
+  const CleanupStats& GetCleanupStats() const {
+    return model_->GetCleanupStats();
+  }
   int GetVertexCount() const { return model_->GetVertexCount(); }
   int GetFacetCount() const { return model_->GetFacetCount(); }
-  const std::vector<std::vector<double>>& GetMatrix3D() const {
-    return model_->GetMatrix3D();
+  const VertexBuffer& GetVertices() const { return model_->GetVertices(); }
+  const VertexBuffer& GetSourceVertices() const {
+    return model_->GetSourceVertices();
+  }
+  void SetVertices(std::vector<double> coords) {
+    model_->SetVertices(std::move(coords));
+  }
+  const CompactVertices& GetCompactVertices() const {
+    return model_->GetCompactVertices();
+  }
+  std::size_t GetBytesPerVertex() const { return model_->GetBytesPerVertex(); }
+  double GetQuantizationError() const {
+    return model_->GetQuantizationError();
+  }
+  const Transform& GetTransform() const { return model_->GetTransform(); }
+  void SetTransform(const Transform& transform) {
+    model_->SetTransform(transform);
+  }
+  BoundingSphere GetBoundingSphere() const {
+    return model_->GetBoundingSphere();
+  }
+  const FacetList& GetFacets() const { return model_->GetFacets(); }
+  const std::vector<int>& GetEdges() const { return model_->GetEdges(); }
+  int GetEdgeCount() const { return model_->GetEdgeCount(); }
+  const std::vector<int>& GetShuffledEdges() const {
+    return model_->GetShuffledEdges();
+  }
+  std::uint64_t GetGeometryVersion() const {
+    return model_->GetGeometryVersion();
+  }
+  LodTask PrepareLods(const std::atomic<bool>* cancel) const {
+    return model_->PrepareLods(cancel);
   }
-  void SetMatrix3D(const std::vector<std::vector<double>>& matrix) {
-    model_->SetMatrix3D(matrix);
+  bool InstallLods(LodChain chain) {
+    return model_->InstallLods(std::move(chain));
   }
-  const std::vector<Facet>& GetPolygons() const {
-    return model_->GetPolygons();
+  const std::vector<LodLevel>& GetLods() const { return model_->GetLods(); }
+  bool AdjacencyBuilt() const { return model_->AdjacencyBuilt(); }
+  const AdjacencyStats& GetAdjacencyStats() const {
+    return model_->GetAdjacency().Stats();
   }
 
  private:
@@ -41,6 +108,7 @@ class Controller {
   Controller& operator=(const Controller&) = delete;
 
   Model* model_;
+  CommandJournal journal;
 };
 
 }  // namespace s21
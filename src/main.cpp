@@ -1,5 +1,6 @@
 #include <QApplication>
 #include <QLocale>
+#include <QSurfaceFormat>
 #include <QTranslator>
 
 #include "controller/controller.h"
@@ -7,8 +8,25 @@
 #include "model/model.h"
 
 int main(int argc, char* argv[]) {
+  // Отрисовка идет шейдерами в core-профиле, его дает и Mesa llvmpipe
+  QSurfaceFormat format;
+  format.setVersion(3, 3);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  format.setDepthBufferSize(24);
+  QSurfaceFormat::setDefaultFormat(format);
   QApplication a(argc, argv);
   s21::Model model;
+  model.SetCacheEnabled(true);
+  model.SetCleanupEnabled(true);
+  if (a.arguments().contains("--adjacency")) {
+    model.SetAdjacencyEnabled(true);
+  }
+  // Для очень больших моделей: --float или --quantized сжимают вершины
+  if (a.arguments().contains("--float")) {
+    model.SetVertexStorage(s21::VertexStorage::kFloat);
+  } else if (a.arguments().contains("--quantized")) {
+    model.SetVertexStorage(s21::VertexStorage::kQuantized);
+  }
   s21::Controller& controller = s21::Controller::getInstance(&model);
   MainWindow w(&controller);
   w.show();
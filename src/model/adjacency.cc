@@ -0,0 +1,156 @@
+#include "adjacency.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "parallel_for.h"
+
+namespace s21 {
+
+namespace {
+
+constexpr std::size_t kGrain = 1 << 13;
+
+// Сжимает списки после удаления повторов: sizes[i] — новая длина списка i,
+// начинающегося с offsets[i].
+void Compact(std::vector<int>& items, std::vector<int>& offsets,
+             const std::vector<int>& sizes, ThreadPool* pool) {
+  std::vector<int> compact_offsets(offsets.size(), 0);
+  for (std::size_t i = 0; i < sizes.size(); i++) {
+    compact_offsets[i + 1] = compact_offsets[i] + sizes[i];
+  }
+  std::vector<int> compact_items(compact_offsets.back());
+  ParallelFor(pool, sizes.size(), kGrain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                  std::copy_n(items.begin() + offsets[i], sizes[i],
+                              compact_items.begin() + compact_offsets[i]);
+                }
+              });
+  items = std::move(compact_items);
+  offsets = std::move(compact_offsets);
+}
+
+}  // namespace
+
+Adjacency Adjacency::Build(const FacetList& facets, std::size_t vertex_count,
+                           ThreadPool* pool) {
+  auto start = std::chrono::steady_clock::now();
+  Adjacency adjacency;
+  const std::vector<int>& indices = facets.Indices();
+  const std::vector<int>& offsets = facets.Offsets();
+
+  // Вершины -> грани сортировкой подсчетом: число вхождений каждой вершины,
+  // префиксные суммы, раскладка по атомарным курсорам.
+  std::vector<std::atomic<int>> cursors(vertex_count);
+  ParallelFor(pool, indices.size(), kGrain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                  cursors[indices[i]].fetch_add(1, std::memory_order_relaxed);
+                }
+              });
+  adjacency.vertex_offsets.assign(vertex_count + 1, 0);
+  for (std::size_t v = 0; v < vertex_count; v++) {
+    adjacency.vertex_offsets[v + 1] = adjacency.vertex_offsets[v] + cursors[v];
+    cursors[v].store(adjacency.vertex_offsets[v], std::memory_order_relaxed);
+  }
+  adjacency.vertex_facets.resize(indices.size());
+  ParallelFor(pool, facets.size(), kGrain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t f = begin; f < end; f++) {
+                  for (int i = offsets[f]; i < offsets[f + 1]; i++) {
+                    int slot = cursors[indices[i]].fetch_add(
+                        1, std::memory_order_relaxed);
+                    adjacency.vertex_facets[slot] = static_cast<int>(f);
+                  }
+                }
+              });
+  // Порядок раскладки зависит от потоков, после сортировки — нет. Грань с
+  // повторяющейся вершиной входит в ее список один раз.
+  std::vector<int> sizes(vertex_count);
+  ParallelFor(pool, vertex_count, kGrain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t v = begin; v < end; v++) {
+                  auto first = adjacency.vertex_facets.begin() +
+                               adjacency.vertex_offsets[v];
+                  auto last = adjacency.vertex_facets.begin() +
+                              adjacency.vertex_offsets[v + 1];
+                  std::sort(first, last);
+                  sizes[v] = static_cast<int>(std::unique(first, last) - first);
+                }
+              });
+  Compact(adjacency.vertex_facets, adjacency.vertex_offsets, sizes, pool);
+
+  // Грани -> соседи: пересечение списков граней концов каждого ребра.
+  // Первый проход считает соседей с повторами, второй их записывает.
+  auto for_each_neighbor = [&](std::size_t f, auto&& visit) {
+    int first = offsets[f];
+    int size = offsets[f + 1] - first;
+    int edges = size == 2 ? 1 : size;
+    for (int i = 0; i < edges; i++) {
+      // Ребро нулевой длины после сварки вершин не связывает грани, как и в
+      // списке ребер
+      int from = indices[first + i];
+      int to = indices[first + (i + 1) % size];
+      if (from == to) {
+        continue;
+      }
+      Span<const int> a = adjacency.FacetsOf(from);
+      Span<const int> b = adjacency.FacetsOf(to);
+      const int* p = a.begin();
+      const int* q = b.begin();
+      while (p != a.end() && q != b.end()) {
+        if (*p < *q) {
+          p++;
+        } else if (*q < *p) {
+          q++;
+        } else {
+          if (*p != static_cast<int>(f)) {
+            visit(*p);
+          }
+          p++;
+          q++;
+        }
+      }
+    }
+  };
+  std::vector<int> counts(facets.size());
+  ParallelFor(pool, facets.size(), kGrain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t f = begin; f < end; f++) {
+                  int count = 0;
+                  for_each_neighbor(f, [&count](int) { count++; });
+                  counts[f] = count;
+                }
+              });
+  adjacency.facet_offsets.assign(facets.size() + 1, 0);
+  for (std::size_t f = 0; f < facets.size(); f++) {
+    adjacency.facet_offsets[f + 1] = adjacency.facet_offsets[f] + counts[f];
+  }
+  adjacency.facet_neighbors.resize(adjacency.facet_offsets.back());
+  ParallelFor(pool, facets.size(), kGrain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t f = begin; f < end; f++) {
+                  auto first = adjacency.facet_neighbors.begin() +
+                               adjacency.facet_offsets[f];
+                  auto next = first;
+                  for_each_neighbor(f, [&next](int g) { *next++ = g; });
+                  std::sort(first, next);
+                  counts[f] = static_cast<int>(std::unique(first, next) - first);
+                }
+              });
+  Compact(adjacency.facet_neighbors, adjacency.facet_offsets, counts, pool);
+
+  adjacency.stats.bytes =
+      sizeof(int) *
+      (adjacency.vertex_offsets.capacity() + adjacency.vertex_facets.capacity() +
+       adjacency.facet_offsets.capacity() +
+       adjacency.facet_neighbors.capacity());
+  adjacency.stats.seconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+  return adjacency;
+}
+
+}  // namespace s21
@@ -0,0 +1,52 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_ADJACENCY_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_ADJACENCY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "facet_list.h"
+#include "span.h"
+#include "thread_pool.h"
+
+namespace s21 {
+
+struct AdjacencyStats {
+  std::size_t bytes = 0;
+  double seconds = 0.0;
+};
+
+// Смежность в формате CSR: грани каждой вершины и соседи каждой грани
+// (грани с общим ребром). Списки упорядочены по возрастанию номеров.
+class Adjacency {
+ public:
+  static Adjacency Build(const FacetList& facets, std::size_t vertex_count,
+                         ThreadPool* pool);
+
+  std::size_t VertexCount() const { return vertex_offsets.size() - 1; }
+  std::size_t FacetCount() const { return facet_offsets.size() - 1; }
+  Span<const int> FacetsOf(std::size_t vertex) const {
+    return Range(vertex_facets, vertex_offsets, vertex);
+  }
+  Span<const int> NeighborsOf(std::size_t facet) const {
+    return Range(facet_neighbors, facet_offsets, facet);
+  }
+  const AdjacencyStats& Stats() const { return stats; }
+
+ private:
+  static Span<const int> Range(const std::vector<int>& items,
+                               const std::vector<int>& offsets,
+                               std::size_t i) {
+    return {items.data() + offsets[i],
+            static_cast<std::size_t>(offsets[i + 1] - offsets[i])};
+  }
+
+  std::vector<int> vertex_offsets{0};
+  std::vector<int> vertex_facets;
+  std::vector<int> facet_offsets{0};
+  std::vector<int> facet_neighbors;
+  AdjacencyStats stats;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_ADJACENCY_H
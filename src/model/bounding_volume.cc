@@ -0,0 +1,41 @@
+#include "bounding_volume.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+
+BoundingBox TransformBox(const BoundingBox& box, const Transform& transform) {
+  BoundingBox result;
+  for (int row = 0; row < 3; row++) {
+    result.min[row] = transform.At(row, 3);
+    result.max[row] = transform.At(row, 3);
+    for (int column = 0; column < 3; column++) {
+      double a = transform.At(row, column) * box.min[column];
+      double b = transform.At(row, column) * box.max[column];
+      result.min[row] += std::min(a, b);
+      result.max[row] += std::max(a, b);
+    }
+  }
+  return result;
+}
+
+BoundingSphere TransformSphere(const BoundingSphere& sphere,
+                               const Transform& transform) {
+  BoundingSphere result;
+  transform.Apply(sphere.center.data(), result.center.data());
+  double scale = transform.UniformScale();
+  if (scale == 0.0) {
+    // Норма Фробениуса не меньше наибольшего растяжения.
+    for (int row = 0; row < 3; row++) {
+      for (int column = 0; column < 3; column++) {
+        scale += transform.At(row, column) * transform.At(row, column);
+      }
+    }
+    scale = std::sqrt(scale);
+  }
+  result.radius = sphere.radius * scale;
+  return result;
+}
+
+}  // namespace s21
@@ -0,0 +1,36 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_BOUNDING_VOLUME_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_BOUNDING_VOLUME_H
+
+#include <array>
+
+#include "transform.h"
+
+namespace s21 {
+
+struct BoundingBox {
+  std::array<double, 3> min{};
+  std::array<double, 3> max{};
+};
+
+struct BoundingSphere {
+  std::array<double, 3> center{};
+  double radius = 0.0;
+};
+
+// Рамка и сфера загруженных вершин, считаются одним проходом.
+struct MeshBounds {
+  std::array<double, 3> centroid{};
+  BoundingBox box;
+  // Наибольшее расстояние вершины от начала координат.
+  double origin_radius = 0.0;
+};
+
+// Рамка, содержащая образ рамки box, без обхода вершин (метод Арво).
+BoundingBox TransformBox(const BoundingBox& box, const Transform& transform);
+// Сфера, содержащая образ сферы sphere.
+BoundingSphere TransformSphere(const BoundingSphere& sphere,
+                               const Transform& transform);
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_BOUNDING_VOLUME_H
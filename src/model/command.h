@@ -1,35 +1,198 @@
 #ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMAND_H
 #define CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMAND_H
 
+#include <cctype>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <typeinfo>
+
 #include "model.h"
 
 namespace s21 {
 
 class Command {
  public:
+  virtual ~Command() = default;
   virtual void execute() = 0;
+  virtual void undo() = 0;
+  // Поглощает следующую команду, если их можно отменять как одну.
+  virtual bool merge(const Command&) { return false; }
 };
 
-class RotateCommand : public Command {
+// Команда, сводящаяся к одному шагу преобразования модели. Отмена
+// применяет обратный шаг, вершины не копируются. Сливаются только команды
+// одного вида вдоль одной оси, чтобы сдвиг кнопкой во время поворота мышью
+// отменялся отдельно.
+class TransformCommand : public Command {
  public:
-  RotateCommand(Model* m, double s, char a) : model(m), step(s), axis(a) {}
-  void execute() override { model->RotateModel(step, axis); }
+  void execute() override { model->ApplyTransform(step); }
+  void undo() override { model->ApplyTransform(step.Inverse()); }
+  bool merge(const Command& next) override {
+    if (typeid(next) != typeid(*this)) {
+      return false;
+    }
+    auto& other = static_cast<const TransformCommand&>(next);
+    if (other.model != model || other.axis != axis) {
+      return false;
+    }
+    step = other.step * step;
+    return true;
+  }
+
+ protected:
+  TransformCommand(Model* m, const Transform& s, char a = '\0')
+      : model(m), step(s), axis(a) {}
 
- private:
   Model* model;
-  double step;
+  Transform step;
   char axis;
 };
 
-class MoveCommand : public Command {
+// Заглавная буква оси задает движение в обратную сторону.
+class RotateCommand : public TransformCommand {
  public:
-  MoveCommand(Model* m, double d, char a) : model(m), distance(d), axis(a) {}
-  void execute() override { model->MoveModel(distance, axis); }
+  RotateCommand(Model* m, double s, char a)
+      : TransformCommand(m, Transform::Rotation(Axis(a), Signed(s, a)),
+                         Axis(a)) {}
 
  private:
-  Model* model;
-  double distance;
-  char axis;
+  static char Axis(char axis) { return static_cast<char>(tolower(axis)); }
+  static double Signed(double value, char axis) {
+    return isupper(axis) ? -value : value;
+  }
+};
+
+class MoveCommand : public TransformCommand {
+ public:
+  MoveCommand(Model* m, double d, char a)
+      : TransformCommand(m, Translation(isupper(a) ? -d : d, a),
+                         static_cast<char>(tolower(a))) {}
+
+ private:
+  static Transform Translation(double distance, char axis) {
+    axis = static_cast<char>(tolower(axis));
+    return Transform::Translation(axis == 'x' ? distance : 0.0,
+                                  axis == 'y' ? distance : 0.0,
+                                  axis == 'z' ? distance : 0.0);
+  }
+};
+
+// Поворот мышью за один кадр: сначала вокруг x, затем вокруг y.
+class DragCommand : public TransformCommand {
+ public:
+  DragCommand(Model* m, double x_step, double y_step)
+      : TransformCommand(m, Transform::Rotation('y', y_step) *
+                                Transform::Rotation('x', x_step)) {}
+};
+
+// Шаг центрирования и масштабирования зависит от текущего положения и
+// запоминается при первом выполнении.
+class CenterCommand : public TransformCommand {
+ public:
+  explicit CenterCommand(Model* m) : TransformCommand(m, Transform()) {}
+  void execute() override {
+    if (!recorded) {
+      Transform before = model->GetTransform();
+      model->CenterModel();
+      step = model->GetTransform() * before.Inverse();
+      recorded = true;
+    } else {
+      TransformCommand::execute();
+    }
+  }
+
+ private:
+  bool recorded = false;
+};
+
+class ScaleCommand : public TransformCommand {
+ public:
+  ScaleCommand(Model* m, double f)
+      : TransformCommand(m, Transform()), factor(f) {}
+  void execute() override {
+    if (!recorded) {
+      Transform before = model->GetTransform();
+      model->ScaleModelToFit(factor);
+      step = model->GetTransform() * before.Inverse();
+      recorded = true;
+    } else {
+      TransformCommand::execute();
+    }
+  }
+
+ private:
+  double factor;
+  bool recorded = false;
+};
+
+// История выполненных команд для отмены и повтора.
+class CommandJournal {
+ public:
+  explicit CommandJournal(std::size_t limit = 256) : limit(limit) {}
+
+  void Execute(std::unique_ptr<Command> command) {
+    command->execute();
+    redo_stack.clear();
+    if (merge_open && !undo_stack.empty() &&
+        undo_stack.back()->merge(*command)) {
+      return;
+    }
+    undo_stack.push_back(std::move(command));
+    if (undo_stack.size() > limit) {
+      undo_stack.pop_front();
+    }
+    merge_open = coalescing;
+  }
+
+  bool Undo() {
+    if (undo_stack.empty()) {
+      return false;
+    }
+    undo_stack.back()->undo();
+    redo_stack.push_back(std::move(undo_stack.back()));
+    undo_stack.pop_back();
+    merge_open = false;
+    return true;
+  }
+
+  bool Redo() {
+    if (redo_stack.empty()) {
+      return false;
+    }
+    redo_stack.back()->execute();
+    undo_stack.push_back(std::move(redo_stack.back()));
+    redo_stack.pop_back();
+    merge_open = false;
+    return true;
+  }
+
+  // Команды между BeginCoalescing и EndCoalescing (например, поворот
+  // мышью) попадают в историю одной записью.
+  void BeginCoalescing() {
+    coalescing = true;
+    merge_open = false;
+  }
+  void EndCoalescing() {
+    coalescing = false;
+    merge_open = false;
+  }
+
+  bool CanUndo() const { return !undo_stack.empty(); }
+  bool CanRedo() const { return !redo_stack.empty(); }
+  std::size_t Size() const { return undo_stack.size(); }
+  void Clear() {
+    undo_stack.clear();
+    redo_stack.clear();
+    merge_open = false;
+  }
+
+ private:
+  std::size_t limit;
+  std::deque<std::unique_ptr<Command>> undo_stack;
+  std::deque<std::unique_ptr<Command>> redo_stack;
+  bool coalescing = false;
+  bool merge_open = false;
 };
 
 }  // namespace s21
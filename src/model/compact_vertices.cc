@@ -0,0 +1,131 @@
+#include "compact_vertices.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "transform_kernel.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+constexpr double kShortRange = 32767.0;
+
+void Widen(const float* in, double* out, std::size_t count) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 4 <= count; i += 4) {
+    __m128 values = _mm_loadu_ps(in + i);
+    _mm_storeu_pd(out + i, _mm_cvtps_pd(values));
+    _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+  }
+#endif
+  for (; i < count; i++) {
+    out[i] = in[i];
+  }
+}
+
+void Widen(const std::int16_t* in, double* out, std::size_t count) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 8 <= count; i += 8) {
+    __m128i values =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    // Расширение со знаком до 32 бит: значение в старшей половине и сдвиг.
+    __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+    __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+    _mm_storeu_pd(out + i, _mm_cvtepi32_pd(low));
+    _mm_storeu_pd(out + i + 2, _mm_cvtepi32_pd(_mm_shuffle_epi32(low, 0xEE)));
+    _mm_storeu_pd(out + i + 4, _mm_cvtepi32_pd(high));
+    _mm_storeu_pd(out + i + 6,
+                  _mm_cvtepi32_pd(_mm_shuffle_epi32(high, 0xEE)));
+  }
+#endif
+  for (; i < count; i++) {
+    out[i] = in[i];
+  }
+}
+
+}  // namespace
+
+void CompactVertices::Encode(const VertexBuffer& source,
+                             VertexStorage new_storage) {
+  Clear();
+  storage = new_storage;
+  Span<const double> coords = source.Coords();
+  if (storage == VertexStorage::kFloat) {
+    floats.assign(coords.begin(), coords.end());
+  } else if (storage == VertexStorage::kQuantized) {
+    double center[3] = {0.0, 0.0, 0.0};
+    double step[3] = {1.0, 1.0, 1.0};
+    for (int k = 0; k < 3 && !source.empty(); k++) {
+      double low = coords[k];
+      double high = coords[k];
+      for (std::size_t i = k; i < coords.size(); i += 3) {
+        low = std::min(low, coords[i]);
+        high = std::max(high, coords[i]);
+      }
+      center[k] = low + (high - low) / 2;
+      if (high > low) {
+        step[k] = (high - low) / 2 / kShortRange;
+      }
+    }
+    shorts.resize(coords.size());
+    for (std::size_t i = 0; i < coords.size(); i++) {
+      double value = std::round((coords[i] - center[i % 3]) / step[i % 3]);
+      shorts[i] = static_cast<std::int16_t>(
+          std::clamp(value, -kShortRange, kShortRange));
+    }
+    dequantization = Transform::Translation(center[0], center[1], center[2]) *
+                     Transform::Scaling(step[0], step[1], step[2]);
+  } else {
+    return;
+  }
+  std::vector<double> decoded(coords.size());
+  Decode(0, source.size(), decoded.data());
+  for (std::size_t i = 0; i < coords.size(); i++) {
+    max_error = std::max(max_error, std::fabs(decoded[i] - coords[i]));
+  }
+}
+
+void CompactVertices::Clear() {
+  storage = VertexStorage::kDouble;
+  floats = std::vector<float>();
+  shorts = std::vector<std::int16_t>();
+  dequantization = Transform();
+  max_error = 0.0;
+}
+
+std::size_t CompactVertices::size() const {
+  return (floats.size() + shorts.size()) / 3;
+}
+
+void CompactVertices::Decode(std::size_t first, std::size_t count,
+                             double* out, const Transform& after) const {
+  if (storage == VertexStorage::kFloat) {
+    Widen(floats.data() + 3 * first, out, 3 * count);
+  } else {
+    Widen(shorts.data() + 3 * first, out, 3 * count);
+  }
+  Transform full = after * dequantization;
+  if (!full.IsIdentity()) {
+    TransformCoords(full, out, out, count);
+  }
+}
+
+std::size_t CompactVertices::BytesPerVertex() const {
+  switch (storage) {
+    case VertexStorage::kFloat:
+      return 3 * sizeof(float);
+    case VertexStorage::kQuantized:
+      return 3 * sizeof(std::int16_t);
+    default:
+      return 3 * sizeof(double);
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,48 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMPACT_VERTICES_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMPACT_VERTICES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "transform.h"
+#include "vertex_buffer.h"
+
+namespace s21 {
+
+enum class VertexStorage { kDouble, kFloat, kQuantized };
+
+// Вершины в сжатом виде: float или 16-битные целые относительно рамки
+// модели. Координаты восстанавливаются преобразованием Dequantization().
+class CompactVertices {
+ public:
+  void Encode(const VertexBuffer& source, VertexStorage storage);
+  void Clear();
+
+  std::size_t size() const;
+  bool empty() const { return size() == 0; }
+  VertexStorage Storage() const { return storage; }
+  const float* Floats() const { return floats.data(); }
+  const std::int16_t* Shorts() const { return shorts.data(); }
+  const Transform& Dequantization() const { return dequantization; }
+
+  // Записывает в out вершины [first, first + count), к которым применено
+  // преобразование after.
+  void Decode(std::size_t first, std::size_t count, double* out,
+              const Transform& after = Transform()) const;
+
+  std::size_t BytesPerVertex() const;
+  // Наибольшее отклонение координаты от исходной, измеренное при сжатии.
+  double MaxError() const { return max_error; }
+
+ private:
+  VertexStorage storage = VertexStorage::kDouble;
+  std::vector<float> floats;
+  std::vector<std::int16_t> shorts;
+  Transform dequantization;
+  double max_error = 0.0;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMPACT_VERTICES_H
@@ -0,0 +1,177 @@
+#include "compressed_file.h"
+
+#include <zlib.h>
+
+#include <stdexcept>
+
+#ifdef S21_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+constexpr std::size_t kInputBlockBytes = 256 << 10;
+constexpr unsigned char kGzipMagic[2] = {0x1f, 0x8b};
+constexpr unsigned char kZstdMagic[4] = {0x28, 0xb5, 0x2f, 0xfd};
+
+enum class Format { kNone, kGzip, kZstd };
+
+Format DetectFormat(std::ifstream& file) {
+  unsigned char magic[4] = {0, 0, 0, 0};
+  file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  std::streamsize count = file.gcount();
+  file.clear();
+  file.seekg(0, std::ios::beg);
+  if (count >= 2 && std::memcmp(magic, kGzipMagic, 2) == 0) {
+    return Format::kGzip;
+  }
+  if (count >= 4 && std::memcmp(magic, kZstdMagic, 4) == 0) {
+    return Format::kZstd;
+  }
+  return Format::kNone;
+}
+
+}  // namespace
+
+class CompressedFile::Decoder {
+ public:
+  virtual ~Decoder() = default;
+  // Распаковывает часть входа, сдвигая next и left. Возвращает число байт.
+  virtual std::size_t Decode(const char*& next, std::size_t& left, char* out,
+                             std::size_t size) = 0;
+  // Поток завершен на границе кадра.
+  virtual bool Finished() const = 0;
+};
+
+namespace {
+
+class GzipDecoder : public CompressedFile::Decoder {
+ public:
+  GzipDecoder() {
+    // 15 + 32: окно 32 КБ и автоматическое определение заголовка gzip/zlib.
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+      throw std::runtime_error("Failed to initialize gzip decoder");
+    }
+  }
+  ~GzipDecoder() override { inflateEnd(&stream); }
+
+  std::size_t Decode(const char*& next, std::size_t& left, char* out,
+                     std::size_t size) override {
+    if (finished) {
+      // Следующий член многочленного gzip-файла.
+      if (left == 0) {
+        return 0;
+      }
+      inflateReset(&stream);
+      finished = false;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(next));
+    stream.avail_in = static_cast<uInt>(left);
+    stream.next_out = reinterpret_cast<Bytef*>(out);
+    stream.avail_out = static_cast<uInt>(size);
+    int result = inflate(&stream, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      finished = true;
+    } else if (result != Z_OK && result != Z_BUF_ERROR) {
+      throw std::runtime_error("Corrupted compressed file");
+    }
+    next = reinterpret_cast<const char*>(stream.next_in);
+    left = stream.avail_in;
+    return size - stream.avail_out;
+  }
+
+  bool Finished() const override { return finished; }
+
+ private:
+  z_stream stream{};
+  bool finished = false;
+};
+
+#ifdef S21_HAVE_ZSTD
+class ZstdDecoder : public CompressedFile::Decoder {
+ public:
+  ZstdDecoder() : stream(ZSTD_createDStream()) {
+    if (!stream) {
+      throw std::runtime_error("Failed to initialize zstd decoder");
+    }
+  }
+  ~ZstdDecoder() override { ZSTD_freeDStream(stream); }
+
+  std::size_t Decode(const char*& next, std::size_t& left, char* out,
+                     std::size_t size) override {
+    ZSTD_inBuffer in{next, left, 0};
+    ZSTD_outBuffer output{out, size, 0};
+    std::size_t result = ZSTD_decompressStream(stream, &output, &in);
+    if (ZSTD_isError(result)) {
+      throw std::runtime_error("Corrupted compressed file");
+    }
+    finished = result == 0;
+    next += in.pos;
+    left -= in.pos;
+    return output.pos;
+  }
+
+  bool Finished() const override { return finished; }
+
+ private:
+  ZSTD_DStream* stream;
+  bool finished = true;
+};
+#endif
+
+}  // namespace
+
+CompressedFile::CompressedFile(const std::string& file_path)
+    : file(file_path, std::ios::binary) {
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open file");
+  }
+  Format format = DetectFormat(file);
+  if (format == Format::kGzip) {
+    decoder = std::make_unique<GzipDecoder>();
+  } else if (format == Format::kZstd) {
+#ifdef S21_HAVE_ZSTD
+    decoder = std::make_unique<ZstdDecoder>();
+#else
+    throw std::runtime_error("Zstandard support is not enabled");
+#endif
+  } else {
+    throw std::runtime_error("Unknown compression format");
+  }
+  file.seekg(0, std::ios::end);
+  length = static_cast<std::size_t>(file.tellg());
+  file.seekg(0, std::ios::beg);
+  input.resize(kInputBlockBytes);
+}
+
+CompressedFile::~CompressedFile() = default;
+
+bool CompressedFile::IsCompressed(const std::string& file_path) {
+  std::ifstream file(file_path, std::ios::binary);
+  return file.is_open() && DetectFormat(file) != Format::kNone;
+}
+
+std::size_t CompressedFile::Read(char* buffer, std::size_t size) {
+  while (true) {
+    if (input_left == 0 && file) {
+      file.read(input.data(), input.size());
+      input_next = input.data();
+      input_left = static_cast<std::size_t>(file.gcount());
+      read_bytes += input_left;
+    }
+    if (input_left == 0 && !file) {
+      if (!decoder->Finished()) {
+        throw std::runtime_error("Unexpected end of compressed file");
+      }
+      return 0;
+    }
+    std::size_t produced = decoder->Decode(input_next, input_left, buffer, size);
+    if (produced > 0) {
+      return produced;
+    }
+  }
+}
+
+}  // namespace s21
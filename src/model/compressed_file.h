@@ -0,0 +1,85 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMPRESSED_FILE_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMPRESSED_FILE_H
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "obj_parser.h"
+
+namespace s21 {
+
+// Распаковывает файл .gz или .zst потоком, не читая его целиком.
+// Поддержка zstd включается флагом S21_HAVE_ZSTD.
+class CompressedFile {
+ public:
+  class Decoder;
+
+  explicit CompressedFile(const std::string& file_path);
+  ~CompressedFile();
+  CompressedFile(const CompressedFile&) = delete;
+  CompressedFile& operator=(const CompressedFile&) = delete;
+
+  // Определяет формат по сигнатуре в начале файла.
+  static bool IsCompressed(const std::string& file_path);
+
+  // Записывает в buffer до size распакованных байт, 0 — конец данных.
+  std::size_t Read(char* buffer, std::size_t size);
+  std::size_t size() const { return length; }
+  std::size_t consumed() const { return read_bytes; }
+
+ private:
+  std::ifstream file;
+  std::unique_ptr<Decoder> decoder;
+  std::vector<char> input;
+  const char* input_next = nullptr;
+  std::size_t input_left = 0;
+  std::size_t length = 0;
+  std::size_t read_bytes = 0;
+};
+
+namespace obj {
+
+constexpr std::size_t kDecompressBlockBytes = 1 << 20;
+
+// Разбирает распакованный текст блоками. Незаконченная строка в конце
+// блока переносится в начало следующего. Возвращает число прочитанных байт.
+template <class Sink>
+std::size_t ParseBlocks(CompressedFile& file, Sink& sink,
+                        LoadProgress& progress) {
+  std::vector<char> buffer;
+  std::size_t tail = 0;
+  std::size_t total = 0;
+  std::size_t reported = 0;
+  while (true) {
+    buffer.resize(tail + kDecompressBlockBytes);
+    std::size_t read = file.Read(buffer.data() + tail, kDecompressBlockBytes);
+    total += read;
+    const char* begin = buffer.data();
+    const char* end = begin + tail + read;
+    const char* last = end;
+    if (read > 0) {
+      while (last > begin && last[-1] != '\n') {
+        last--;
+      }
+    }
+    ParseLines(begin, last, sink);
+    progress.Advance(file.consumed() - reported);
+    reported = file.consumed();
+    sink.OnBlockEnd();
+    if (read == 0) {
+      return total;
+    }
+    tail = end - last;
+    std::memmove(buffer.data(), last, tail);
+  }
+}
+
+}  // namespace obj
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_COMPRESSED_FILE_H
@@ -0,0 +1,115 @@
+#include "edge_list.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "parallel_for.h"
+
+namespace s21 {
+
+namespace {
+
+constexpr std::size_t kFacetGrain = 1 << 14;
+constexpr std::size_t kPartitions = 64;
+constexpr std::uint64_t kNoEdge = ~std::uint64_t{0};
+
+std::uint64_t EdgeKey(int a, int b) {
+  if (a == b) {
+    return kNoEdge;
+  }
+  if (a > b) {
+    std::swap(a, b);
+  }
+  return (static_cast<std::uint64_t>(a) << 32) | static_cast<std::uint32_t>(b);
+}
+
+// Разделы выбираются по перемешанному ключу, чтобы соседние вершины не
+// попадали в один раздел.
+std::size_t PartitionOf(std::uint64_t key) {
+  return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 58);
+}
+
+}  // namespace
+
+std::vector<int> ExtractEdges(const FacetList& facets, ThreadPool* pool) {
+  const std::vector<int>& indices = facets.Indices();
+  const std::vector<int>& offsets = facets.Offsets();
+  std::size_t chunks = (facets.size() + kFacetGrain - 1) / kFacetGrain;
+
+  // Ключ ребра от каждого угла грани к следующему, по разделам внутри
+  // каждого куска граней: сначала подсчет, затем раскладка.
+  std::vector<std::size_t> counts(chunks * kPartitions, 0);
+  ParallelFor(pool, facets.size(), kFacetGrain,
+              [&](std::size_t begin, std::size_t end) {
+                std::size_t* count = &counts[begin / kFacetGrain * kPartitions];
+                for (std::size_t f = begin; f < end; f++) {
+                  int first = offsets[f];
+                  int size = offsets[f + 1] - first;
+                  // У грани из двух вершин одно ребро.
+                  int edges = size == 2 ? 1 : size;
+                  for (int i = 0; i < edges; i++) {
+                    std::uint64_t key = EdgeKey(
+                        indices[first + i], indices[first + (i + 1) % size]);
+                    if (key != kNoEdge) {
+                      count[PartitionOf(key)]++;
+                    }
+                  }
+                }
+              });
+  // Начало каждого куска в каждом разделе; разделы идут друг за другом.
+  std::vector<std::size_t> starts(counts.size());
+  std::vector<std::size_t> partition_begin(kPartitions + 1, 0);
+  std::size_t total = 0;
+  for (std::size_t p = 0; p < kPartitions; p++) {
+    partition_begin[p] = total;
+    for (std::size_t c = 0; c < chunks; c++) {
+      starts[c * kPartitions + p] = total;
+      total += counts[c * kPartitions + p];
+    }
+  }
+  partition_begin[kPartitions] = total;
+
+  std::vector<std::uint64_t> keys(total);
+  ParallelFor(pool, facets.size(), kFacetGrain,
+              [&](std::size_t begin, std::size_t end) {
+                std::size_t* next = &starts[begin / kFacetGrain * kPartitions];
+                for (std::size_t f = begin; f < end; f++) {
+                  int first = offsets[f];
+                  int size = offsets[f + 1] - first;
+                  int edges = size == 2 ? 1 : size;
+                  for (int i = 0; i < edges; i++) {
+                    std::uint64_t key = EdgeKey(
+                        indices[first + i], indices[first + (i + 1) % size]);
+                    if (key != kNoEdge) {
+                      keys[next[PartitionOf(key)]++] = key;
+                    }
+                  }
+                }
+              });
+
+  // Разделы не пересекаются по ключам и очищаются от повторов независимо.
+  std::vector<std::size_t> unique(kPartitions + 1, 0);
+  ParallelFor(pool, kPartitions, 1, [&](std::size_t p, std::size_t) {
+    auto first = keys.begin() + partition_begin[p];
+    auto last = keys.begin() + partition_begin[p + 1];
+    std::sort(first, last);
+    unique[p + 1] = std::unique(first, last) - first;
+  });
+  for (std::size_t p = 0; p < kPartitions; p++) {
+    unique[p + 1] += unique[p];
+  }
+
+  std::vector<int> edges(2 * unique[kPartitions]);
+  ParallelFor(pool, kPartitions, 1, [&](std::size_t p, std::size_t) {
+    std::size_t count = unique[p + 1] - unique[p];
+    const std::uint64_t* source = keys.data() + partition_begin[p];
+    int* target = edges.data() + 2 * unique[p];
+    for (std::size_t i = 0; i < count; i++) {
+      target[2 * i] = static_cast<int>(source[i] >> 32);
+      target[2 * i + 1] = static_cast<int>(source[i] & 0xFFFFFFFFu);
+    }
+  });
+  return edges;
+}
+
+}  // namespace s21
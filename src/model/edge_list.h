@@ -0,0 +1,18 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_EDGE_LIST_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_EDGE_LIST_H
+
+#include <vector>
+
+#include "facet_list.h"
+#include "thread_pool.h"
+
+namespace s21 {
+
+// Уникальные ребра граней парами индексов вершин: a0 b0 a1 b1 ..., в каждой
+// паре a < b. Ребро, общее для нескольких граней, входит один раз, ребра
+// из одной вершины отбрасываются. Порядок не зависит от числа потоков.
+std::vector<int> ExtractEdges(const FacetList& facets, ThreadPool* pool);
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_EDGE_LIST_H
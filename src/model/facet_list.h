@@ -0,0 +1,81 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_FACET_LIST_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_FACET_LIST_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "span.h"
+
+namespace s21 {
+
+// Грани в формате CSR: индексы вершин всех граней подряд и смещения начала
+// каждой грани. Грань f занимает indices[offsets[f], offsets[f + 1]).
+class FacetList {
+ public:
+  class Iterator {
+   public:
+    Iterator(const FacetList* list, std::size_t facet)
+        : list(list), facet(facet) {}
+    Span<const int> operator*() const { return (*list)[facet]; }
+    Iterator& operator++() {
+      facet++;
+      return *this;
+    }
+    bool operator!=(const Iterator& other) const {
+      return facet != other.facet;
+    }
+
+   private:
+    const FacetList* list;
+    std::size_t facet;
+  };
+
+  std::size_t size() const { return offsets.size() - 1; }
+  bool empty() const { return size() == 0; }
+  Span<const int> operator[](std::size_t facet) const {
+    return {indices.data() + offsets[facet],
+            static_cast<std::size_t>(offsets[facet + 1] - offsets[facet])};
+  }
+  Iterator begin() const { return {this, 0}; }
+  Iterator end() const { return {this, size()}; }
+
+  const std::vector<int>& Indices() const { return indices; }
+  const std::vector<int>& Offsets() const { return offsets; }
+  // Индексы можно переписать на месте, не меняя границ граней.
+  std::vector<int>& MutableIndices() { return indices; }
+
+  void Clear() {
+    indices.clear();
+    offsets.assign(1, 0);
+  }
+  void Reserve(std::size_t facets, std::size_t count) {
+    offsets.reserve(facets + 1);
+    indices.reserve(count);
+  }
+  void Assign(std::vector<int> new_indices, std::vector<int> new_offsets) {
+    indices = std::move(new_indices);
+    offsets = std::move(new_offsets);
+  }
+
+  // Добавление: индексы копятся в открытой грани, Close() ее завершает.
+  void Push(int index) { indices.push_back(index); }
+  void Append(const int* first, const int* last) {
+    indices.insert(indices.end(), first, last);
+  }
+  std::size_t OpenSize() const { return indices.size() - offsets.back(); }
+  void Close() { offsets.push_back(static_cast<int>(indices.size())); }
+
+  bool operator==(const FacetList& other) const {
+    return indices == other.indices && offsets == other.offsets;
+  }
+  bool operator!=(const FacetList& other) const { return !(*this == other); }
+
+ private:
+  std::vector<int> indices;
+  std::vector<int> offsets{0};
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_FACET_LIST_H
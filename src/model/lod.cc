@@ -0,0 +1,413 @@
+#include "lod.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "edge_list.h"
+
+namespace s21 {
+
+namespace {
+
+// Вес плоскостей вдоль границы относительно плоскостей граней.
+constexpr double kBoundaryWeight = 100.0;
+constexpr std::size_t kCancelCheckInterval = 1024;
+constexpr std::size_t kDecodeChunk = 1 << 13;
+
+using Triangle = std::array<int, 3>;
+// Записывает в out координаты вершин [first, first + count).
+using VertexReader =
+    std::function<void(std::size_t first, std::size_t count, double* out)>;
+
+// Симметричная матрица 4x4 квадрики ошибки, хранится верхний треугольник:
+// aa ab ac ad bb bc bd cc cd dd.
+class Quadric {
+ public:
+  void AddPlane(const double* normal, double d, double weight) {
+    double plane[4] = {normal[0], normal[1], normal[2], d};
+    int k = 0;
+    for (int i = 0; i < 4; i++) {
+      for (int j = i; j < 4; j++) {
+        q[k++] += weight * plane[i] * plane[j];
+      }
+    }
+  }
+
+  Quadric& operator+=(const Quadric& other) {
+    for (int k = 0; k < 10; k++) {
+      q[k] += other.q[k];
+    }
+    return *this;
+  }
+
+  double Error(const double* p) const {
+    double x = p[0];
+    double y = p[1];
+    double z = p[2];
+    return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z +
+           2 * q[3] * x + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y +
+           q[7] * z * z + 2 * q[8] * z + q[9];
+  }
+
+ private:
+  std::array<double, 10> q{};
+};
+
+struct Candidate {
+  double cost;
+  int a;
+  int b;
+  int stamp_a;
+  int stamp_b;
+  std::array<double, 3> position;
+
+  bool operator>(const Candidate& other) const { return cost > other.cost; }
+};
+
+void Cross(const double* u, const double* v, double* result) {
+  result[0] = u[1] * v[2] - u[2] * v[1];
+  result[1] = u[2] * v[0] - u[0] * v[2];
+  result[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+double Dot(const double* u, const double* v) {
+  return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+}
+
+void Normal(const double* a, const double* b, const double* c,
+            double* normal) {
+  double u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+  double v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+  Cross(u, v, normal);
+}
+
+std::uint64_t EdgeKey(int a, int b) {
+  if (a > b) {
+    std::swap(a, b);
+  }
+  return static_cast<std::uint64_t>(a) << 32 | static_cast<std::uint32_t>(b);
+}
+
+class Simplifier {
+ public:
+  Simplifier(std::size_t vertex_count, const VertexReader& read,
+             const FacetList& facets)
+      : coords(3 * vertex_count),
+        quadrics(vertex_count),
+        incident(vertex_count),
+        stamps(vertex_count, 0),
+        removed_vertices(vertex_count, 0) {
+    for (std::size_t first = 0; first < vertex_count; first += kDecodeChunk) {
+      std::size_t count = std::min(kDecodeChunk, vertex_count - first);
+      read(first, count, &coords[3 * first]);
+    }
+    // Многоугольники разбиваются веером.
+    for (Span<const int> facet : facets) {
+      for (std::size_t i = 2; i < facet.size(); i++) {
+        Triangle triangle = {facet[0], facet[i - 1], facet[i]};
+        if (triangle[0] != triangle[1] && triangle[1] != triangle[2] &&
+            triangle[0] != triangle[2]) {
+          triangles.push_back(triangle);
+        }
+      }
+    }
+    removed_triangles.assign(triangles.size(), 0);
+    live = triangles.size();
+    for (std::size_t t = 0; t < triangles.size(); t++) {
+      for (int v : triangles[t]) {
+        incident[v].push_back(static_cast<int>(t));
+      }
+    }
+    AddFacePlanes();
+  }
+
+  std::size_t TriangleCount() const { return triangles.size(); }
+
+  // Стягивает ребра, пока треугольников больше target.
+  bool Reduce(std::size_t target, const std::atomic<bool>* cancel) {
+    std::size_t steps = 0;
+    while (live > target && !heap.empty()) {
+      if (cancel && ++steps % kCancelCheckInterval == 0 && cancel->load()) {
+        return false;
+      }
+      Candidate candidate = heap.top();
+      heap.pop();
+      if (removed_vertices[candidate.a] || removed_vertices[candidate.b] ||
+          stamps[candidate.a] != candidate.stamp_a ||
+          stamps[candidate.b] != candidate.stamp_b ||
+          Flips(candidate.a, candidate.b, candidate.position.data()) ||
+          Flips(candidate.b, candidate.a, candidate.position.data())) {
+        continue;
+      }
+      Collapse(candidate.a, candidate.b, candidate.position.data());
+    }
+    return true;
+  }
+
+  LodLevel Snapshot() const {
+    LodLevel level;
+    std::vector<int> remap(removed_vertices.size(), -1);
+    for (std::size_t t = 0; t < triangles.size(); t++) {
+      if (removed_triangles[t]) {
+        continue;
+      }
+      for (int v : triangles[t]) {
+        if (remap[v] < 0) {
+          remap[v] = static_cast<int>(level.vertices.size());
+          level.vertices.Append(&coords[3 * v], &coords[3 * v] + 3);
+        }
+        level.facets.Push(remap[v]);
+      }
+      level.facets.Close();
+    }
+    level.edges = ExtractEdges(level.facets, nullptr);
+    return level;
+  }
+
+ private:
+  const double* Point(int v) const { return &coords[3 * v]; }
+
+  void AddFacePlanes() {
+    std::vector<std::pair<std::uint64_t, int>> edges;
+    edges.reserve(3 * triangles.size());
+    for (std::size_t t = 0; t < triangles.size(); t++) {
+      const Triangle& triangle = triangles[t];
+      double normal[3];
+      Normal(Point(triangle[0]), Point(triangle[1]), Point(triangle[2]),
+             normal);
+      double length = std::sqrt(Dot(normal, normal));
+      for (int i = 0; i < 3; i++) {
+        edges.emplace_back(EdgeKey(triangle[i], triangle[(i + 1) % 3]),
+                           static_cast<int>(t));
+      }
+      if (length == 0.0) {
+        continue;
+      }
+      // Вес — площадь грани.
+      for (double& component : normal) {
+        component /= length;
+      }
+      double d = -Dot(normal, Point(triangle[0]));
+      Quadric plane;
+      plane.AddPlane(normal, d, length / 2);
+      for (int v : triangle) {
+        quadrics[v] += plane;
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (std::size_t i = 0; i < edges.size();) {
+      std::size_t j = i + 1;
+      while (j < edges.size() && edges[j].first == edges[i].first) {
+        j++;
+      }
+      int a = static_cast<int>(edges[i].first >> 32);
+      int b = static_cast<int>(edges[i].first & 0xFFFFFFFFU);
+      if (j - i == 1) {
+        AddBoundaryPlane(a, b, triangles[edges[i].second]);
+      }
+      i = j;
+    }
+    // Кандидаты строятся после всех квадрик.
+    for (std::size_t i = 0; i < edges.size(); i++) {
+      if (i == 0 || edges[i].first != edges[i - 1].first) {
+        Push(static_cast<int>(edges[i].first >> 32),
+             static_cast<int>(edges[i].first & 0xFFFFFFFFU));
+      }
+    }
+  }
+
+  // Плоскость через граничное ребро перпендикулярно его грани.
+  void AddBoundaryPlane(int a, int b, const Triangle& triangle) {
+    double face[3];
+    Normal(Point(triangle[0]), Point(triangle[1]), Point(triangle[2]), face);
+    const double* pa = Point(a);
+    const double* pb = Point(b);
+    double edge[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+    double normal[3];
+    Cross(edge, face, normal);
+    double length = std::sqrt(Dot(normal, normal));
+    if (length == 0.0) {
+      return;
+    }
+    for (double& component : normal) {
+      component /= length;
+    }
+    Quadric plane;
+    plane.AddPlane(normal, -Dot(normal, pa), kBoundaryWeight * Dot(edge, edge));
+    quadrics[a] += plane;
+    quadrics[b] += plane;
+  }
+
+  void Push(int a, int b) {
+    Quadric sum = quadrics[a];
+    sum += quadrics[b];
+    Candidate candidate{0.0, a, b, stamps[a], stamps[b], {}};
+    double* p = candidate.position.data();
+    // Точка ищется на самом ребре: свободный оптимум квадрики на почти
+    // плоских зашумленных участках плохо обусловлен и уходит от поверхности.
+    // Вдоль ребра ошибка — парабола, она восстанавливается по трем точкам.
+    const double* pa = Point(a);
+    const double* pb = Point(b);
+    double middle[3] = {(pa[0] + pb[0]) / 2, (pa[1] + pb[1]) / 2,
+                        (pa[2] + pb[2]) / 2};
+    double e0 = sum.Error(pa);
+    double e1 = sum.Error(pb);
+    double square = 2 * e0 + 2 * e1 - 4 * sum.Error(middle);
+    double linear = e1 - e0 - square;
+    double t = e0 <= e1 ? 0.0 : 1.0;
+    if (square > 0.0) {
+      t = std::clamp(-linear / (2 * square), 0.0, 1.0);
+    }
+    for (int i = 0; i < 3; i++) {
+      p[i] = pa[i] + t * (pb[i] - pa[i]);
+    }
+    candidate.cost = std::max(0.0, sum.Error(p));
+    heap.push(candidate);
+  }
+
+  // Перевернется ли грань вершины from, не содержащая other, после переноса
+  // from в p.
+  bool Flips(int from, int other, const double* p) const {
+    for (int t : incident[from]) {
+      const Triangle& triangle = triangles[t];
+      if (removed_triangles[t] ||
+          std::find(triangle.begin(), triangle.end(), other) !=
+              triangle.end()) {
+        continue;
+      }
+      const double* corners[3];
+      const double* moved[3];
+      for (int i = 0; i < 3; i++) {
+        corners[i] = Point(triangle[i]);
+        moved[i] = triangle[i] == from ? p : corners[i];
+      }
+      double before[3];
+      double after[3];
+      Normal(corners[0], corners[1], corners[2], before);
+      Normal(moved[0], moved[1], moved[2], after);
+      if (Dot(before, before) > 0.0 && Dot(before, after) <= 0.0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Вершина b сливается с a, a переносится в p.
+  void Collapse(int a, int b, const double* p) {
+    std::copy(p, p + 3, &coords[3 * a]);
+    quadrics[a] += quadrics[b];
+    removed_vertices[b] = 1;
+    stamps[a]++;
+    stamps[b]++;
+    for (int t : incident[b]) {
+      if (removed_triangles[t]) {
+        continue;
+      }
+      Triangle& triangle = triangles[t];
+      if (std::find(triangle.begin(), triangle.end(), a) != triangle.end()) {
+        removed_triangles[t] = 1;
+        live--;
+        continue;
+      }
+      std::replace(triangle.begin(), triangle.end(), b, a);
+      incident[a].push_back(t);
+    }
+    std::vector<int>().swap(incident[b]);
+    std::vector<int>& around = incident[a];
+    around.erase(std::remove_if(around.begin(), around.end(),
+                                [this](int t) { return removed_triangles[t]; }),
+                 around.end());
+    std::sort(around.begin(), around.end());
+    around.erase(std::unique(around.begin(), around.end()), around.end());
+    std::vector<int> neighbors;
+    for (int t : around) {
+      for (int v : triangles[t]) {
+        if (v != a) {
+          neighbors.push_back(v);
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+    for (int v : neighbors) {
+      Push(a, v);
+    }
+  }
+
+  std::vector<double> coords;
+  std::vector<Quadric> quadrics;
+  std::vector<std::vector<int>> incident;
+  std::vector<int> stamps;
+  std::vector<char> removed_vertices;
+  std::vector<Triangle> triangles;
+  std::vector<char> removed_triangles;
+  std::size_t live = 0;
+  std::priority_queue<Candidate, std::vector<Candidate>,
+                      std::greater<Candidate>>
+      heap;
+};
+
+}  // namespace
+
+namespace {
+
+std::vector<LodLevel> Simplify(std::size_t vertex_count,
+                               const VertexReader& read,
+                               const FacetList& facets,
+                               std::vector<double> ratios,
+                               const std::atomic<bool>* cancel) {
+  std::vector<LodLevel> levels;
+  Simplifier simplifier(vertex_count, read, facets);
+  std::size_t total = simplifier.TriangleCount();
+  if (total == 0) {
+    return levels;
+  }
+  std::sort(ratios.begin(), ratios.end(), std::greater<double>());
+  for (double ratio : ratios) {
+    if (!(ratio > 0.0 && ratio < 1.0)) {
+      continue;
+    }
+    auto target = static_cast<std::size_t>(ratio * static_cast<double>(total));
+    if (!simplifier.Reduce(std::max<std::size_t>(target, 1), cancel)) {
+      break;
+    }
+    levels.push_back(simplifier.Snapshot());
+  }
+  return levels;
+}
+
+}  // namespace
+
+std::vector<LodLevel> SimplifyMesh(const VertexBuffer& vertices,
+                                   const FacetList& facets,
+                                   std::vector<double> ratios,
+                                   const std::atomic<bool>* cancel) {
+  return Simplify(
+      vertices.size(),
+      [&vertices](std::size_t first, std::size_t count, double* out) {
+        std::copy(vertices[first], vertices[first + count], out);
+      },
+      facets, std::move(ratios), cancel);
+}
+
+std::vector<LodLevel> SimplifyMesh(const LodSource& source,
+                                   std::vector<double> ratios,
+                                   const std::atomic<bool>* cancel) {
+  if (source.compact.empty()) {
+    return SimplifyMesh(source.vertices, source.facets, std::move(ratios),
+                        cancel);
+  }
+  return Simplify(
+      source.compact.size(),
+      [&source](std::size_t first, std::size_t count, double* out) {
+        source.compact.Decode(first, count, out);
+      },
+      source.facets, std::move(ratios), cancel);
+}
+
+}  // namespace s21
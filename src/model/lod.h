@@ -0,0 +1,55 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_LOD_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_LOD_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "compact_vertices.h"
+#include "facet_list.h"
+#include "vertex_buffer.h"
+
+namespace s21 {
+
+// Упрощенная копия модели из треугольников в координатах исходной модели.
+struct LodLevel {
+  VertexBuffer vertices;
+  FacetList facets;
+  std::vector<int> edges;
+};
+
+// Цепочка уровней от подробного к грубому для версии геометрии, с которой
+// она строилась.
+struct LodChain {
+  std::uint64_t geometry_version = 0;
+  std::vector<LodLevel> levels;
+};
+
+using LodTask = std::function<LodChain()>;
+
+// Снимок геометрии для упрощения в фоне. Сжатые вершины хранятся как есть
+// и раскодируются кусками уже в потоке упрощения; vertices заполняется,
+// только если compact пуст.
+struct LodSource {
+  CompactVertices compact;
+  VertexBuffer vertices;
+  FacetList facets;
+};
+
+// Упрощение стягиванием ребер по квадрикам ошибки (Garland, Heckbert).
+// Для каждой доли из ratios строится уровень, в котором остается примерно
+// такая доля треугольников. Новая вершина ставится на стягиваемое ребро,
+// границы открытых сеток удерживаются штрафными плоскостями. При
+// установленном cancel возвращает уже готовые уровни.
+std::vector<LodLevel> SimplifyMesh(const VertexBuffer& vertices,
+                                   const FacetList& facets,
+                                   std::vector<double> ratios,
+                                   const std::atomic<bool>* cancel = nullptr);
+std::vector<LodLevel> SimplifyMesh(const LodSource& source,
+                                   std::vector<double> ratios,
+                                   const std::atomic<bool>* cancel = nullptr);
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_LOD_H
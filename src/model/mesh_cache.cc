@@ -0,0 +1,261 @@
+#include "mesh_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace s21 {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', '2', '1', 'M', 'E', 'S', 'H', '\0'};
+constexpr std::uint32_t kVersion = 3;
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t path_length;
+  std::uint64_t source_size;
+  std::int64_t source_mtime;
+  std::uint64_t source_hash;
+  std::uint64_t vertex_count;
+  std::uint64_t polygon_count;
+  std::uint64_t index_count;
+  std::int64_t facet_count;
+  std::uint64_t payload_hash;
+};
+
+std::size_t Align8(std::size_t size) { return (size + 7) & ~std::size_t(7); }
+
+struct Layout {
+  std::size_t path = sizeof(Header);
+  std::size_t vertices = 0;
+  std::size_t offsets = 0;
+  std::size_t indices = 0;
+  std::size_t total = 0;
+
+  Layout(std::size_t path_length, std::size_t vertex_count,
+         std::size_t polygon_count, std::size_t index_count) {
+    vertices = path + Align8(path_length);
+    offsets = vertices + 3 * vertex_count * sizeof(double);
+    indices = offsets + (polygon_count + 1) * sizeof(std::int32_t);
+    total = indices + index_count * sizeof(std::int32_t);
+  }
+};
+
+std::uint64_t PayloadHash(const std::string& padded_path,
+                          const MeshArrays& mesh) {
+  std::uint64_t hash = MeshCache::Hash(padded_path.data(), padded_path.size());
+  hash = MeshCache::Hash(reinterpret_cast<const char*>(mesh.vertices),
+                         3 * mesh.vertex_count * sizeof(double), hash);
+  hash = MeshCache::Hash(reinterpret_cast<const char*>(mesh.offsets),
+                         (mesh.polygon_count + 1) * sizeof(std::int32_t), hash);
+  return MeshCache::Hash(reinterpret_cast<const char*>(mesh.indices),
+                         mesh.index_count * sizeof(std::int32_t), hash);
+}
+
+std::string PaddedPath(const std::string& obj_path) {
+  std::string padded = obj_path;
+  padded.resize(Align8(obj_path.size()), '\0');
+  return padded;
+}
+
+std::string AbsolutePath(const std::string& path) {
+  std::error_code error;
+  auto absolute = std::filesystem::absolute(path, error);
+  return error ? path : absolute.lexically_normal().string();
+}
+
+}  // namespace
+
+MeshCache::MeshCache(std::string directory) : directory(std::move(directory)) {
+  if (this->directory.empty()) {
+    std::error_code error;
+    auto temp = std::filesystem::temp_directory_path(error);
+    this->directory =
+        error ? std::string() : (temp / "s21_3dviewer_cache").string();
+  }
+}
+
+CacheKey MeshCache::KeyFor(const std::string& obj_path) {
+  CacheKey key;
+  std::error_code error;
+  auto mtime = std::filesystem::last_write_time(obj_path, error);
+  if (!error) {
+    key.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+  }
+  auto size = std::filesystem::file_size(obj_path, error);
+  if (!error) {
+    key.size = size;
+  }
+  return key;
+}
+
+std::uint64_t MeshCache::ContentHash(const std::string& obj_path) {
+  MappedFile file(obj_path);
+  return Hash(file.begin(), file.size());
+}
+
+std::uint64_t MeshCache::Hash(const char* data, std::size_t size,
+                              std::uint64_t seed) {
+  const std::uint64_t kMultiplier = 0x9E3779B97F4A7C15ULL;
+  std::uint64_t hash = seed ^ (size * kMultiplier);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 32;
+  }
+  std::uint64_t tail = 0;
+  if (i < size) {
+    std::memcpy(&tail, data + i, size - i);
+  }
+  hash = (hash ^ tail) * kMultiplier;
+  return hash ^ (hash >> 29);
+}
+
+std::string MeshCache::CachePath(const std::string& obj_path) const {
+  if (directory.empty()) {
+    return std::string();
+  }
+  std::string absolute = AbsolutePath(obj_path);
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.s21cache",
+                static_cast<unsigned long long>(
+                    Hash(absolute.data(), absolute.size())));
+  return (std::filesystem::path(directory) / name).string();
+}
+
+std::unique_ptr<MappedFile> MeshCache::Open(const std::string& obj_path,
+                                            const CacheKey& key,
+                                            MeshArrays& mesh) const {
+  if (directory.empty()) {
+    return nullptr;
+  }
+  std::unique_ptr<MappedFile> file;
+  try {
+    file = std::make_unique<MappedFile>(CachePath(obj_path));
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+  Header header{};
+  if (file->size() < sizeof(Header)) {
+    return nullptr;
+  }
+  std::memcpy(&header, file->begin(), sizeof(Header));
+  std::string path = AbsolutePath(obj_path);
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.source_size != key.size ||
+      header.source_mtime != key.mtime ||
+      header.path_length != path.size() ||
+      header.vertex_count > file->size() ||
+      header.polygon_count > file->size() ||
+      header.index_count > file->size()) {
+    return nullptr;
+  }
+  Layout layout(header.path_length, header.vertex_count, header.polygon_count,
+                header.index_count);
+  if (layout.total != file->size() ||
+      std::memcmp(file->begin() + layout.path, path.data(), path.size()) != 0) {
+    return nullptr;
+  }
+  // Время изменения могли вернуть назад, поэтому при совпадении
+  // размера и времени содержимое все равно сверяется с хешем.
+  try {
+    if (ContentHash(obj_path) != header.source_hash) {
+      return nullptr;
+    }
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+  const char* base = file->begin();
+  MeshArrays arrays;
+  arrays.vertices = reinterpret_cast<const double*>(base + layout.vertices);
+  arrays.vertex_count = header.vertex_count;
+  arrays.offsets = reinterpret_cast<const std::int32_t*>(base + layout.offsets);
+  arrays.polygon_count = header.polygon_count;
+  arrays.indices = reinterpret_cast<const std::int32_t*>(base + layout.indices);
+  arrays.index_count = header.index_count;
+  arrays.facet_count = header.facet_count;
+  if (PayloadHash(PaddedPath(path), arrays) != header.payload_hash ||
+      arrays.offsets[0] != 0 ||
+      static_cast<std::size_t>(arrays.offsets[arrays.polygon_count]) !=
+          arrays.index_count) {
+    return nullptr;
+  }
+  for (std::size_t i = 0; i < arrays.polygon_count; i++) {
+    if (arrays.offsets[i] > arrays.offsets[i + 1]) {
+      return nullptr;
+    }
+  }
+  // Хеш защищает только от порчи файла, индексы за пределами вершин
+  // проверяются отдельно, иначе ими потом индексируется буфер вершин.
+  for (std::size_t i = 0; i < arrays.index_count; i++) {
+    if (arrays.indices[i] < 0 ||
+        static_cast<std::size_t>(arrays.indices[i]) >= arrays.vertex_count) {
+      return nullptr;
+    }
+  }
+  mesh = arrays;
+  return file;
+}
+
+bool MeshCache::Store(const std::string& obj_path, const CacheKey& key,
+                      const MeshArrays& mesh) const {
+  if (directory.empty()) {
+    return false;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  std::string cache_path = CachePath(obj_path);
+  std::string path = AbsolutePath(obj_path);
+  std::string padded = PaddedPath(path);
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.path_length = static_cast<std::uint32_t>(path.size());
+  header.source_size = key.size;
+  header.source_mtime = key.mtime;
+  try {
+    header.source_hash = ContentHash(obj_path);
+  } catch (const std::exception&) {
+    return false;
+  }
+  header.vertex_count = mesh.vertex_count;
+  header.polygon_count = mesh.polygon_count;
+  header.index_count = mesh.index_count;
+  header.facet_count = mesh.facet_count;
+  header.payload_hash = PayloadHash(padded, mesh);
+
+  std::string temp_path = cache_path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padded.data(), padded.size());
+    file.write(reinterpret_cast<const char*>(mesh.vertices),
+               3 * mesh.vertex_count * sizeof(double));
+    file.write(reinterpret_cast<const char*>(mesh.offsets),
+               (mesh.polygon_count + 1) * sizeof(std::int32_t));
+    file.write(reinterpret_cast<const char*>(mesh.indices),
+               mesh.index_count * sizeof(std::int32_t));
+    if (!file.good()) {
+      file.close();
+      std::remove(temp_path.c_str());
+      return false;
+    }
+  }
+  std::filesystem::rename(temp_path, cache_path, error);
+  if (error) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace s21
@@ -0,0 +1,57 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_MESH_CACHE_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_MESH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "obj_parser.h"
+
+namespace s21 {
+
+struct CacheKey {
+  std::uint64_t size = 0;
+  std::int64_t mtime = 0;
+};
+
+// Плоское представление сетки, в котором она хранится в кэше.
+struct MeshArrays {
+  const double* vertices = nullptr;
+  std::size_t vertex_count = 0;
+  const std::int32_t* offsets = nullptr;
+  std::size_t polygon_count = 0;
+  const std::int32_t* indices = nullptr;
+  std::size_t index_count = 0;
+  std::int64_t facet_count = 0;
+};
+
+class MeshCache {
+ public:
+  // Пустой directory означает каталог s21_3dviewer_cache во временной
+  // папке системы, рядом с самими моделями кэш не пишется.
+  explicit MeshCache(std::string directory = "");
+
+  // Ключ файла: размер и время изменения, без чтения содержимого.
+  static CacheKey KeyFor(const std::string& obj_path);
+  static std::uint64_t ContentHash(const std::string& obj_path);
+  static std::uint64_t Hash(const char* data, std::size_t size,
+                            std::uint64_t seed = 0);
+
+  std::string CachePath(const std::string& obj_path) const;
+
+  // Открывает действительный кэш для файла или возвращает nullptr.
+  // Содержимое файла хешируется, только если совпали размер и время.
+  std::unique_ptr<MappedFile> Open(const std::string& obj_path,
+                                   const CacheKey& key,
+                                   MeshArrays& mesh) const;
+  bool Store(const std::string& obj_path, const CacheKey& key,
+             const MeshArrays& mesh) const;
+
+ private:
+  std::string directory;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_MESH_CACHE_H
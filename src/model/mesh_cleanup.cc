@@ -0,0 +1,146 @@
+#include "mesh_cleanup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace s21 {
+
+namespace {
+
+std::uint64_t Mix(std::uint64_t hash, std::uint64_t value) {
+  hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+std::uint64_t BitsOf(double value) {
+  if (value == 0.0) {
+    value = 0.0;
+  }
+  std::uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+std::uint64_t CellKey(std::int64_t x, std::int64_t y, std::int64_t z) {
+  return Mix(Mix(Mix(0, x), y), z);
+}
+
+}  // namespace
+
+std::vector<int> WeldVertices(const std::vector<double>& coords,
+                              double epsilon, std::vector<double>& welded) {
+  int count = static_cast<int>(coords.size() / 3);
+  std::vector<int> remap(count);
+  welded.clear();
+  welded.reserve(coords.size());
+  // Цепочки уникальных вершин по ячейкам: первая вершина ячейки в cells,
+  // следующая — в next.
+  std::unordered_map<std::uint64_t, int> cells;
+  cells.reserve(count);
+  std::vector<int> next;
+  next.reserve(count);
+  bool exact = !(epsilon > 0.0);
+  double epsilon2 = epsilon * epsilon;
+
+  auto find_in_cell = [&](std::uint64_t key, const double* p) {
+    auto cell = cells.find(key);
+    for (int u = cell == cells.end() ? -1 : cell->second; u >= 0;
+         u = next[u]) {
+      const double* q = &welded[3 * u];
+      double dx = p[0] - q[0];
+      double dy = p[1] - q[1];
+      double dz = p[2] - q[2];
+      if (exact ? (dx == 0.0 && dy == 0.0 && dz == 0.0)
+                : dx * dx + dy * dy + dz * dz <= epsilon2) {
+        return u;
+      }
+    }
+    return -1;
+  };
+
+  for (int v = 0; v < count; v++) {
+    const double* p = &coords[3 * v];
+    std::uint64_t own_key = 0;
+    int found = -1;
+    if (exact) {
+      own_key = CellKey(BitsOf(p[0]), BitsOf(p[1]), BitsOf(p[2]));
+      found = find_in_cell(own_key, p);
+    } else {
+      std::int64_t cell[3];
+      for (int k = 0; k < 3; k++) {
+        cell[k] = static_cast<std::int64_t>(std::floor(p[k] / epsilon));
+      }
+      own_key = CellKey(cell[0], cell[1], cell[2]);
+      for (int dx = -1; dx <= 1 && found < 0; dx++) {
+        for (int dy = -1; dy <= 1 && found < 0; dy++) {
+          for (int dz = -1; dz <= 1 && found < 0; dz++) {
+            found = find_in_cell(
+                CellKey(cell[0] + dx, cell[1] + dy, cell[2] + dz), p);
+          }
+        }
+      }
+    }
+    if (found < 0) {
+      found = static_cast<int>(next.size());
+      welded.insert(welded.end(), p, p + 3);
+      auto inserted = cells.emplace(own_key, found);
+      next.push_back(inserted.second ? -1 : inserted.first->second);
+      inserted.first->second = found;
+    }
+    remap[v] = found;
+  }
+  return remap;
+}
+
+bool IsDegenerateFacet(const int* indices, int size,
+                       const std::vector<double>& coords) {
+  if (size < 2) {
+    return true;
+  }
+  int distinct = 0;
+  for (int i = 0; i < size && distinct < 3; i++) {
+    if (std::find(indices, indices + i, indices[i]) == indices + i) {
+      distinct++;
+    }
+  }
+  if (size == 2 || distinct < 3) {
+    return distinct < std::min(size, 3);
+  }
+  // Удвоенная векторная площадь многоугольника по формуле Ньюэлла.
+  double nx = 0.0;
+  double ny = 0.0;
+  double nz = 0.0;
+  for (int i = 0; i < size; i++) {
+    const double* a = &coords[3 * indices[i]];
+    const double* b = &coords[3 * indices[(i + 1) % size]];
+    nx += (a[1] - b[1]) * (a[2] + b[2]);
+    ny += (a[2] - b[2]) * (a[0] + b[0]);
+    nz += (a[0] - b[0]) * (a[1] + b[1]);
+  }
+  return nx == 0.0 && ny == 0.0 && nz == 0.0;
+}
+
+bool FacetSet::Insert(const int* indices, int size) {
+  sorted.assign(indices, indices + size);
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  std::uint64_t hash = sorted.size();
+  for (int index : sorted) {
+    hash = Mix(hash, static_cast<std::uint64_t>(index));
+  }
+  auto range = buckets.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    int id = it->second;
+    if (std::equal(sorted.begin(), sorted.end(), keys.begin() + offsets[id],
+                   keys.begin() + offsets[id + 1])) {
+      return false;
+    }
+  }
+  buckets.emplace(hash, static_cast<int>(offsets.size()) - 1);
+  keys.insert(keys.end(), sorted.begin(), sorted.end());
+  offsets.push_back(static_cast<int>(keys.size()));
+  return true;
+}
+
+}  // namespace s21
@@ -0,0 +1,43 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_MESH_CLEANUP_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_MESH_CLEANUP_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace s21 {
+
+struct CleanupStats {
+  int removed_vertices = 0;
+  int removed_facets = 0;
+};
+
+// Склеивает вершины, расстояние между которыми не больше epsilon, с
+// помощью хеш-сетки с ячейкой epsilon. При epsilon <= 0 склеиваются только
+// совпадающие точки. coords — массив xyz; возвращает новый номер каждой
+// вершины (с нуля), а в welded записывает оставшиеся вершины в порядке
+// первого появления.
+std::vector<int> WeldVertices(const std::vector<double>& coords,
+                              double epsilon, std::vector<double>& welded);
+
+// Грань вырождена, если в ней меньше трех разных вершин (для отрезка —
+// меньше двух) или ее площадь равна нулю. Индексы начинаются с нуля.
+bool IsDegenerateFacet(const int* indices, int size,
+                       const std::vector<double>& coords);
+
+// Запоминает множества вершин граней независимо от порядка обхода.
+class FacetSet {
+ public:
+  // Возвращает false, если грань с теми же вершинами уже встречалась.
+  bool Insert(const int* indices, int size);
+
+ private:
+  std::vector<int> keys;
+  std::vector<int> offsets{0};
+  std::unordered_multimap<std::uint64_t, int> buckets;
+  std::vector<int> sorted;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_MESH_CLEANUP_H
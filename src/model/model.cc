@@ -1,13 +1,230 @@
 #include "model.h"
 
+#include <algorithm>
+#include <atomic>
+#include <random>
+
 namespace s21 {
 
+namespace {
+
+constexpr std::size_t kParallelMinBytes = 1 << 20;
+constexpr unsigned kChunksPerThread = 4;
+// Проходы по вершинам и граням меньших моделей идут в одном потоке.
+constexpr std::size_t kParallelMinItems = 1 << 16;
+constexpr std::size_t kVertexGrain = 1 << 13;
+// Постоянное зерно: выборка ребер одинакова от запуска к запуску.
+constexpr std::uint32_t kShuffleSeed = 21;
+
+// Переводит индекс OBJ (с 1 или отрицательный) в номер вершины с нуля.
+int ResolveIndex(int index, int vertex_count) {
+  index = index < 0 ? index + vertex_count : index - 1;
+  if (index < 0 || index >= vertex_count) {
+    throw std::runtime_error("Invalid vertex index");
+  }
+  return index;
+}
+
+// Номера версий общие для всех моделей: после подмены модели через
+// CommitModel версия не может совпасть с прежней.
+std::uint64_t NextGeometryVersion() {
+  static std::atomic<std::uint64_t> next{1};
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+int TrianglesInFacet(int count) { return count == 2 ? 1 : count - 2; }
+
+void RunTasks(ThreadPool& pool, std::size_t count,
+              const std::function<void(std::size_t)>& task) {
+  std::vector<std::future<void>> pending;
+  pending.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    pending.push_back(pool.Submit([&task, i] { task(i); }));
+  }
+  for (auto& result : pending) {
+    result.get();
+  }
+}
+
+class BatchPublisher {
+ public:
+  explicit BatchPublisher(const LoadControl& control)
+      : control(control), next_send(Clock::now() + control.batch_interval) {}
+
+  bool Enabled() const { return static_cast<bool>(control.batch); }
+
+  void Publish(const VertexBuffer& vertices, const FacetList& facets) {
+    if (!Enabled() || Clock::now() < next_send) {
+      return;
+    }
+    pending.coords.insert(pending.coords.end(), vertices[vertices_sent],
+                          vertices[vertices.size()]);
+    const auto& offsets = facets.Offsets();
+    pending.indices.insert(pending.indices.end(),
+                           facets.Indices().begin() + offsets[facets_sent],
+                           facets.Indices().begin() + offsets.back());
+    for (std::size_t f = facets_sent; f < facets.size(); f++) {
+      pending.facet_sizes.push_back(offsets[f + 1] - offsets[f]);
+    }
+    vertices_sent = vertices.size();
+    facets_sent = facets.size();
+    Send();
+  }
+
+  // Куски завершаются в любом порядке, а публикуются в порядке файла.
+  void ChunkDone(std::size_t index, const std::vector<obj::ObjChunk>& chunks) {
+    if (!Enabled()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    done.resize(chunks.size(), false);
+    done[index] = true;
+    while (next_chunk < done.size() && done[next_chunk]) {
+      AppendChunk(chunks[next_chunk++]);
+    }
+    if (Clock::now() >= next_send) {
+      Send();
+    }
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void AppendChunk(const obj::ObjChunk& chunk) {
+    pending.coords.insert(pending.coords.end(), chunk.coords.begin(),
+                          chunk.coords.end());
+    for (int line = 0; line < chunk.LineCount(); line++) {
+      int first = chunk.line_offsets[line];
+      int last = chunk.line_offsets[line + 1];
+      int vertex_count =
+          static_cast<int>(vertices_sent) + chunk.line_marks[line];
+      std::size_t rollback = pending.indices.size();
+      bool valid = last - first > 1;
+      for (int k = first; valid && k < last; k++) {
+        int index = chunk.indices[k];
+        index = index < 0 ? index + vertex_count : index - 1;
+        valid = index >= 0 && index < vertex_count;
+        pending.indices.push_back(index);
+      }
+      if (valid) {
+        pending.facet_sizes.push_back(last - first);
+      } else {
+        pending.indices.resize(rollback);
+      }
+    }
+    vertices_sent += chunk.VertexCount();
+  }
+
+  void Send() {
+    next_send = Clock::now() + control.batch_interval;
+    if (pending.coords.empty() && pending.facet_sizes.empty()) {
+      return;
+    }
+    LoadBatch batch;
+    std::swap(batch, pending);
+    pending.first_vertex =
+        batch.first_vertex + static_cast<int>(batch.coords.size() / 3);
+    control.batch(std::move(batch));
+  }
+
+  const LoadControl& control;
+  Clock::time_point next_send;
+  LoadBatch pending;
+  std::size_t vertices_sent = 0;
+  std::size_t facets_sent = 0;
+  std::mutex mutex;
+  std::vector<bool> done;
+  std::size_t next_chunk = 0;
+};
+
+class MeshSink {
+ public:
+  static constexpr bool kAttributes = false;
+
+  MeshSink(VertexBuffer& vertices, FacetList& facets,
+           BatchPublisher& publisher)
+      : vertices(vertices), facets(facets), publisher(publisher) {}
+
+  void OnVertex(double x, double y, double z) {
+    vertices.Push(x, y, z);
+  }
+
+  void OnFacetIndex(int index) {
+    facets.Push(ResolveIndex(index, static_cast<int>(vertices.size())));
+  }
+
+  // Строка из одного индекса продолжается следующей строкой граней.
+  void OnFacetEnd(int count) {
+    if (count > 1) {
+      facets_total += TrianglesInFacet(count);
+      facets.Close();
+    }
+  }
+
+  void OnBlockEnd() { publisher.Publish(vertices, facets); }
+
+  int facets_total = 0;
+
+ private:
+  VertexBuffer& vertices;
+  FacetList& facets;
+  BatchPublisher& publisher;
+};
+
+// Индексы атрибутов разрешаются относительно уже прочитанных vt и vn.
+class AttributeSink {
+ public:
+  static constexpr bool kAttributes = true;
+
+  explicit AttributeSink(AttributeStreams& streams) : streams(streams) {}
+
+  void OnTexCoord(double u, double v) {
+    streams.tex_coords.push_back(u);
+    streams.tex_coords.push_back(v);
+  }
+
+  void OnNormal(double x, double y, double z) {
+    streams.normals.push_back(x);
+    streams.normals.push_back(y);
+    streams.normals.push_back(z);
+  }
+
+  void OnFacetToken(int texture, int normal) {
+    streams.tex_indices.push_back(
+        Resolve(texture, static_cast<int>(streams.tex_coords.size() / 2)));
+    streams.normal_indices.push_back(
+        Resolve(normal, static_cast<int>(streams.normals.size() / 3)));
+  }
+
+  void OnBlockEnd() {}
+
+ private:
+  static int Resolve(int index, int count) {
+    if (index == 0) {
+      return 0;
+    }
+    if (index < 0) {
+      index += count + 1;
+    }
+    if (index <= 0 || index > count) {
+      throw std::runtime_error("Invalid attribute index");
+    }
+    return index;
+  }
+
+  AttributeStreams& streams;
+};
+
+}  // namespace
+
 Model::Model()
     : count_of_vertices(0),
       count_of_facets(0),
       rotation_x(0.0),
       rotation_y(0.0),
-      rotation_z(0.0) {}
+      rotation_z(0.0) {
+  GeometryChanged();
+}
 
 Model::~Model() { ClearData(); }
 
@@ -40,16 +257,368 @@ void Model::CountVerticesAndFacets(const std::string& file_path) {
 }
 
 void Model::ParseModelData(const std::string& file_path) {
+  auto start = std::chrono::steady_clock::now();
+  load_stats = LoadStats();
+  ResetSource(file_path);
+  if (CompressedFile::IsCompressed(file_path)) {
+    ParseCompressedData(file_path);
+  } else if (load_mode == LoadMode::kStream) {
+    ParseStreamData(file_path);
+  } else if (load_mode == LoadMode::kMapped) {
+    ParseMappedData(file_path);
+  } else {
+    ParseParallelData(file_path);
+  }
+  load_stats.seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+}
+
+void Model::LoadModelData(const std::string& file_path) {
+  if (cache_enabled) {
+    LoadCachedData(file_path);
+  } else {
+    ParseModelData(file_path);
+  }
+  if (cleanup_enabled) {
+    CleanupMesh();
+  }
+  if (vertex_storage != VertexStorage::kDouble) {
+    Compact();
+  }
+  GetEdges();
+  if (adjacency_enabled) {
+    GetAdjacency();
+  }
+}
+
+void Model::LoadCachedData(const std::string& file_path) {
+  auto start = std::chrono::steady_clock::now();
+  ResetSource(file_path);
+  MeshCache cache(cache_directory);
+  CacheKey key = MeshCache::KeyFor(file_path);
+  MeshArrays mesh;
+  if (auto file = cache.Open(file_path, key, mesh)) {
+    ReadMeshArrays(mesh);
+    load_stats = LoadStats();
+    load_stats.bytes = file->size();
+    load_stats.from_cache = true;
+    load_stats.seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    LoadProgress(load_control, file->size()).Advance(file->size());
+    return;
+  }
+  ParseModelData(file_path);
+  StoreMeshCache(cache, file_path, key);
+}
+
+const AttributeStreams& Model::GetAttributes() const {
+  if (!attributes) {
+    auto streams = std::make_unique<AttributeStreams>();
+    AttributeSink sink(*streams);
+    if (CompressedFile::IsCompressed(source_path)) {
+      CompressedFile file(source_path);
+      LoadControl control;
+      LoadProgress progress(control, file.size());
+      obj::ParseBlocks(file, sink, progress);
+    } else if (!source_path.empty()) {
+      MappedFile file(source_path);
+      obj::ParseLines(file.begin(), file.end(), sink);
+    }
+    if (kept_corners && (kept_corners->empty() ||
+                         kept_corners->back() <
+                             static_cast<int>(streams->tex_indices.size()))) {
+      for (std::size_t i = 0; i < kept_corners->size(); i++) {
+        int corner = (*kept_corners)[i];
+        streams->tex_indices[i] = streams->tex_indices[corner];
+        streams->normal_indices[i] = streams->normal_indices[corner];
+      }
+      streams->tex_indices.resize(kept_corners->size());
+      streams->normal_indices.resize(kept_corners->size());
+    }
+    attributes = std::move(streams);
+  }
+  return *attributes;
+}
+
+void Model::ResetSource(const std::string& file_path) {
+  source_path = file_path;
+  attributes.reset();
+  kept_corners.reset();
+  cleanup_stats = CleanupStats();
+  SetTransform(Transform());
+  transformed.Clear();
+  compact.Clear();
+  VerticesChanged();
+  TopologyChanged();
+}
+
+void Model::CleanupMesh() {
+  bool compacted = !compact.empty();
+  Expand();
+  Span<const double> source = vertices.Coords();
+  std::vector<double> coords(source.begin(), source.end());
+  int vertex_count = static_cast<int>(vertices.size());
+  std::vector<double> welded;
+  std::vector<int> remap = WeldVertices(coords, weld_epsilon, welded);
+
+  const auto& indices = facets.Indices();
+  const auto& offsets = facets.Offsets();
+  std::vector<int> kept_indices;
+  std::vector<int> kept_offsets{0};
+  kept_indices.reserve(indices.size());
+  kept_offsets.reserve(offsets.size());
+  FacetSet seen;
+  std::vector<int> facet;
+  std::vector<int> corners;
+  int facets_total = 0;
+  for (std::size_t f = 0; f < facets.size(); f++) {
+    auto first = indices.begin() + offsets[f];
+    auto last = indices.begin() + offsets[f + 1];
+    int size = offsets[f + 1] - offsets[f];
+    facet.clear();
+    for (auto it = first; it != last; ++it) {
+      facet.push_back(remap[*it]);
+    }
+    if (IsDegenerateFacet(facet.data(), size, welded) ||
+        !seen.Insert(facet.data(), size)) {
+      continue;
+    }
+    kept_indices.insert(kept_indices.end(), facet.begin(), facet.end());
+    kept_offsets.push_back(static_cast<int>(kept_indices.size()));
+    for (int i = offsets[f]; i < offsets[f + 1]; i++) {
+      corners.push_back(kept_corners ? (*kept_corners)[i] : i);
+    }
+    facets_total += TrianglesInFacet(size);
+  }
+  cleanup_stats.removed_vertices +=
+      vertex_count - static_cast<int>(welded.size() / 3);
+  cleanup_stats.removed_facets +=
+      static_cast<int>(facets.size() + 1 - kept_offsets.size());
+  facets.Assign(std::move(kept_indices), std::move(kept_offsets));
+  vertices.Assign(std::move(welded));
+  kept_corners = std::move(corners);
+  count_of_vertices = static_cast<int>(vertices.size());
+  count_of_facets = facets_total;
+  attributes.reset();
+  VerticesChanged();
+  TopologyChanged();
+  if (compacted) {
+    Compact();
+  }
+}
+
+void Model::ReadMeshArrays(const MeshArrays& mesh) {
+  vertices.Assign(std::vector<double>(
+      mesh.vertices, mesh.vertices + 3 * mesh.vertex_count));
+  facets.Assign(
+      std::vector<int>(mesh.indices, mesh.indices + mesh.index_count),
+      std::vector<int>(mesh.offsets, mesh.offsets + mesh.polygon_count + 1));
+  count_of_vertices = static_cast<int>(mesh.vertex_count);
+  count_of_facets = static_cast<int>(mesh.facet_count);
+}
+
+bool Model::StoreMeshCache(const MeshCache& cache, const std::string& file_path,
+                           const CacheKey& key) const {
+  MeshArrays mesh;
+  mesh.vertices = vertices.data();
+  mesh.vertex_count = vertices.size();
+  mesh.offsets = facets.Offsets().data();
+  mesh.polygon_count = facets.size();
+  mesh.indices = facets.Indices().data();
+  mesh.index_count = facets.Indices().size();
+  mesh.facet_count = count_of_facets;
+  return cache.Store(file_path, key, mesh);
+}
+
+void Model::ParseMappedData(const std::string& file_path) {
+  MappedFile file(file_path);
+  load_stats.bytes = file.size();
+  ParseMappedRange(file.begin(), file.end());
+}
+
+void Model::ParseMappedRange(const char* begin, const char* end) {
+  LoadProgress progress(load_control, end - begin);
+  vertices.Clear();
+  facets.Clear();
+  BatchPublisher publisher(load_control);
+  MeshSink sink(vertices, facets, publisher);
+  obj::ParseLines(begin, end, sink, progress);
+  if (facets.OpenSize() > 0) {
+    facets.Close();
+  }
+  count_of_vertices = static_cast<int>(vertices.size());
+  count_of_facets = sink.facets_total;
+}
+
+void Model::ParseCompressedData(const std::string& file_path) {
+  CompressedFile file(file_path);
+  LoadProgress progress(load_control, file.size());
+  vertices.Clear();
+  facets.Clear();
+  BatchPublisher publisher(load_control);
+  MeshSink sink(vertices, facets, publisher);
+  load_stats.bytes = obj::ParseBlocks(file, sink, progress);
+  if (facets.OpenSize() > 0) {
+    facets.Close();
+  }
+  count_of_vertices = static_cast<int>(vertices.size());
+  count_of_facets = sink.facets_total;
+}
+
+void Model::ParseParallelData(const std::string& file_path) {
+  MappedFile file(file_path);
+  load_stats.bytes = file.size();
+  unsigned threads =
+      load_threads > 0 ? load_threads : ThreadPool::DefaultThreads();
+  if (threads < 2 || file.size() < kParallelMinBytes) {
+    ParseMappedRange(file.begin(), file.end());
+    return;
+  }
+  auto ranges =
+      obj::SplitLines(file.begin(), file.end(), threads * kChunksPerThread);
+  std::vector<obj::ObjChunk> chunks(ranges.size());
+  LoadProgress progress(load_control, file.size());
+  BatchPublisher publisher(load_control);
+  RunTasks(*Pool(), chunks.size(), [&](std::size_t i) {
+    try {
+      obj::ParseLines(ranges[i].first, ranges[i].second, chunks[i], progress);
+    } catch (...) {
+      chunks[i].error = std::current_exception();
+    }
+    publisher.ChunkDone(i, chunks);
+  });
+  if (load_control.Cancelled()) {
+    throw LoadCancelled();
+  }
+  StitchChunks(chunks);
+}
+
+void Model::StitchChunks(const std::vector<obj::ObjChunk>& chunks) {
+  struct Layout {
+    int vertices_before = 0;
+    int facet_base = 0;
+    int index_base = 0;
+    int closed_lines = 0;
+    std::vector<int> carry;
+    std::exception_ptr fill_error;
+    std::exception_ptr carry_error;
+  };
+  std::vector<Layout> layouts(chunks.size());
+  std::vector<int> carry;
+  int vertices_total = 0;
+  int facets_closed = 0;
+  int indices_closed = 0;
+  int facets_total = 0;
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    const auto& chunk = chunks[i];
+    Layout& layout = layouts[i];
+    layout.vertices_before = vertices_total;
+    layout.facet_base = facets_closed;
+    layout.index_base = indices_closed;
+    int last_closed = -1;
+    for (int line = 0; line < chunk.LineCount(); line++) {
+      int count = chunk.line_offsets[line + 1] - chunk.line_offsets[line];
+      if (count > 1) {
+        last_closed = line;
+        layout.closed_lines++;
+        facets_total += TrianglesInFacet(count);
+      }
+    }
+    if (layout.closed_lines > 0) {
+      layout.carry.swap(carry);
+      carry.clear();
+      indices_closed += static_cast<int>(layout.carry.size()) +
+                        chunk.line_offsets[last_closed + 1];
+    }
+    try {
+      for (int line = last_closed + 1; line < chunk.LineCount(); line++) {
+        int vertex_count = vertices_total + chunk.line_marks[line];
+        for (int k = chunk.line_offsets[line];
+             k < chunk.line_offsets[line + 1]; k++) {
+          carry.push_back(ResolveIndex(chunk.indices[k], vertex_count));
+        }
+      }
+    } catch (...) {
+      layout.carry_error = std::current_exception();
+    }
+    vertices_total += chunk.VertexCount();
+    facets_closed += layout.closed_lines;
+  }
+
+  vertices.Clear();
+  vertices.Resize(vertices_total);
+  std::vector<int> indices(indices_closed + carry.size());
+  std::vector<int> offsets(facets_closed + (carry.empty() ? 1 : 2), 0);
+  RunTasks(*Pool(), chunks.size(), [&](std::size_t i) {
+    const auto& chunk = chunks[i];
+    Layout& layout = layouts[i];
+    std::copy(chunk.coords.begin(), chunk.coords.end(),
+              vertices[layout.vertices_before]);
+    if (layout.closed_lines == 0) {
+      return;
+    }
+    int position = layout.index_base;
+    for (int index : layout.carry) {
+      indices[position++] = index;
+    }
+    int facet = layout.facet_base;
+    try {
+      for (int line = 0; facet < layout.facet_base + layout.closed_lines;
+           line++) {
+        int vertex_count = layout.vertices_before + chunk.line_marks[line];
+        for (int k = chunk.line_offsets[line];
+             k < chunk.line_offsets[line + 1]; k++) {
+          indices[position++] = ResolveIndex(chunk.indices[k], vertex_count);
+        }
+        if (chunk.line_offsets[line + 1] - chunk.line_offsets[line] > 1) {
+          offsets[++facet] = position;
+        }
+      }
+    } catch (...) {
+      layout.fill_error = std::current_exception();
+    }
+  });
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    for (const auto& error :
+         {layouts[i].fill_error, layouts[i].carry_error, chunks[i].error}) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+  if (!carry.empty()) {
+    std::copy(carry.begin(), carry.end(), indices.begin() + indices_closed);
+    offsets.back() = static_cast<int>(indices.size());
+  }
+  facets.Assign(std::move(indices), std::move(offsets));
+  count_of_vertices = vertices_total;
+  count_of_facets = facets_total;
+}
+
+void Model::ParseStreamData(const std::string& file_path) {
   std::ifstream file(file_path);
   if (!file.is_open()) {
     throw std::runtime_error("Failed to open file");
   }
+  file.seekg(0, std::ios::end);
+  LoadProgress progress(load_control, static_cast<std::size_t>(file.tellg()));
+  file.seekg(0, std::ios::beg);
   std::string line;
-  int vertex_index = 1, facet_index = 1, count_vertex = 0;
-  double x = 0, y = 0, z = 0;
-  matrix_3d.resize(count_of_vertices + 1, std::vector<double>(3, 0.0));
-  polygons.resize(count_of_facets + 1);
+  std::size_t block_bytes = 0;
+  BatchPublisher publisher(load_control);
+  int facets_total = 0;
+  vertices.Clear();
+  facets.Clear();
   while (std::getline(file, line)) {
+    load_stats.bytes += line.size() + 1;
+    block_bytes += line.size() + 1;
+    if (block_bytes >= obj::kProgressBlockBytes) {
+      progress.Advance(block_bytes);
+      publisher.Publish(vertices, facets);
+      block_bytes = 0;
+    }
     if (line.substr(0, 2) == "v ") {
       std::istringstream iss(line.substr(2));
       std::vector<double> coords;
@@ -60,39 +629,36 @@ void Model::ParseModelData(const std::string& file_path) {
       if (coords.size() != 3) {
         throw std::runtime_error("Each vertex must have exactly 3 coordinates");
       }
-      x = coords[0];
-      y = coords[1];
-      z = coords[2];
-      if (vertex_index > count_of_vertices) {
-        throw std::runtime_error("Vertex index out of bounds");
-      }
-      matrix_3d[vertex_index][0] = x;
-      matrix_3d[vertex_index][1] = y;
-      matrix_3d[vertex_index][2] = z;
-      vertex_index++;
-      count_vertex++;
+      vertices.Push(coords[0], coords[1], coords[2]);
     } else if (line.substr(0, 2) == "f ") {
       std::istringstream iss(line.substr(2));
       std::string token;
+      int vertex_count = static_cast<int>(vertices.size());
       int count_vertex_in_facets = 0;
       while (iss >> token) {
-        int current_vertex_index = std::stoi(token);
-        if (current_vertex_index < 0) {
-          current_vertex_index = count_vertex + 1 + current_vertex_index;
-        }
-        if (current_vertex_index == 0 || current_vertex_index > vertex_index) {
-          throw std::runtime_error("Invalid vertex index");
-        } else {
-          polygons[facet_index].vertices.push_back(current_vertex_index);
-          count_vertex_in_facets++;
+        int current_vertex_index = 0;
+        const char* first = token.data();
+        if (!obj::ParseFacetToken(first, first + token.size(),
+                                  current_vertex_index)) {
+          throw std::runtime_error("Invalid facet token");
         }
+        facets.Push(ResolveIndex(current_vertex_index, vertex_count));
+        count_vertex_in_facets++;
       }
-      polygons[facet_index].count_vertices_in_facets = count_vertex_in_facets;
       if (count_vertex_in_facets > 1) {
-        facet_index++;
+        facets_total += count_vertex_in_facets == 2
+                            ? count_vertex_in_facets - 1
+                            : count_vertex_in_facets - 2;
+        facets.Close();
       }
     }
   }
+  if (facets.OpenSize() > 0) {
+    facets.Close();
+  }
+  progress.Advance(block_bytes);
+  count_of_vertices = static_cast<int>(vertices.size());
+  count_of_facets = facets_total;
   file.close();
 }
 
@@ -121,35 +687,13 @@ void Model::RotateModel(double step, char xyz) {
   }
 }
 
-void Model::RotatePoint(std::vector<double>& point, double angle, char xyz) {
-  double cos_result = cos(angle);
-  double sin_result = sin(angle);
-  double temp = 0;
-  switch (xyz) {
-    case 'x':
-      temp = point[1] * cos_result - point[2] * sin_result;
-      point[2] = point[1] * sin_result + point[2] * cos_result;
-      point[1] = temp;
-      break;
-    case 'y':
-      temp = point[0] * cos_result + point[2] * sin_result;
-      point[2] = -point[0] * sin_result + point[2] * cos_result;
-      point[0] = temp;
-      break;
-    case 'z':
-      temp = point[0] * cos_result - point[1] * sin_result;
-      point[1] = point[0] * sin_result + point[1] * cos_result;
-      point[0] = temp;
-      break;
-  }
-}
-
 void Model::ApplyRotation() {
-  for (int i = 1; i <= count_of_vertices; i++) {
-    RotatePoint(matrix_3d[i], rotation_x, 'x');
-    RotatePoint(matrix_3d[i], rotation_y, 'y');
-    RotatePoint(matrix_3d[i], rotation_z, 'z');
+  if (rotation_x == 0.0 && rotation_y == 0.0 && rotation_z == 0.0) {
+    return;
   }
+  Compose(Transform::Rotation('z', rotation_z) *
+          Transform::Rotation('y', rotation_y) *
+          Transform::Rotation('x', rotation_x));
   rotation_x = 0.0;
   rotation_y = 0.0;
   rotation_z = 0.0;
@@ -158,34 +702,22 @@ void Model::ApplyRotation() {
 void Model::MoveModel(double distance, char xyz) {
   switch (xyz) {
     case 'x':
-      for (int i = 1; i <= count_of_vertices; i++) {
-        matrix_3d[i][0] += distance;
-      }
+      Compose(Transform::Translation(distance, 0.0, 0.0));
       break;
     case 'y':
-      for (int i = 1; i <= count_of_vertices; i++) {
-        matrix_3d[i][1] += distance;
-      }
+      Compose(Transform::Translation(0.0, distance, 0.0));
       break;
     case 'z':
-      for (int i = 1; i <= count_of_vertices; i++) {
-        matrix_3d[i][2] += distance;
-      }
+      Compose(Transform::Translation(0.0, 0.0, distance));
       break;
     case 'X':
-      for (int i = 1; i <= count_of_vertices; i++) {
-        matrix_3d[i][0] -= distance;
-      }
+      Compose(Transform::Translation(-distance, 0.0, 0.0));
       break;
     case 'Y':
-      for (int i = 1; i <= count_of_vertices; i++) {
-        matrix_3d[i][1] -= distance;
-      }
+      Compose(Transform::Translation(0.0, -distance, 0.0));
       break;
     case 'Z':
-      for (int i = 1; i <= count_of_vertices; i++) {
-        matrix_3d[i][2] -= distance;
-      }
+      Compose(Transform::Translation(0.0, 0.0, -distance));
       break;
     default:
       break;
@@ -193,60 +725,349 @@ void Model::MoveModel(double distance, char xyz) {
 }
 
 void Model::CenterModel() {
-  const auto& vertices = this->GetMatrix3D();
-  if (vertices.empty()) {
+  if (SourceSize() == 0) {
     throw std::runtime_error("Empty model");
   }
+  // Центр масс переходит в центр масс преобразованных вершин.
+  double moved[3];
+  transform.Apply(Bounds().centroid.data(), moved);
 
-  double center_x = 0.0;
-  double center_y = 0.0;
-  double center_z = 0.0;
+  Compose(Transform::Translation(-moved[0], -moved[1], -moved[2]));
+}
 
-  for (const auto& vertex : vertices) {
-    center_x += vertex[0];
-    center_y += vertex[1];
-    center_z += vertex[2];
+void Model::ScaleModelToFit(double scale_factor) {
+  if (SourceSize() == 0) {
+    throw std::runtime_error("Empty model");
   }
 
-  int vertex_count = this->GetVertexCount();
-  center_x /= vertex_count;
-  center_y /= vertex_count;
-  center_z /= vertex_count;
+  double max_distance = FitRadius();
+  if (max_distance > 0.0) {
+    Compose(Transform::Scaling(scale_factor / max_distance));
+  }
+}
 
-  this->MoveModel(-center_x, 'x');
-  this->MoveModel(-center_y, 'y');
-  this->MoveModel(-center_z, 'z');
+void Model::NormalizeModel(double scale_factor) {
+  CenterModel();
+  ScaleModelToFit(scale_factor);
 }
 
-void Model::ScaleModelToFit(double scale_factor) {
-  const auto& vertices = this->GetMatrix3D();
-  if (vertices.empty()) {
-    throw std::runtime_error("Empty model");
+BoundingBox Model::GetBoundingBox() const {
+  return SourceSize() == 0 ? BoundingBox()
+                          : TransformBox(Bounds().box, transform);
+}
+
+BoundingSphere Model::GetBoundingSphere() const {
+  if (SourceSize() == 0) {
+    return BoundingSphere();
   }
+  BoundingSphere sphere{Bounds().centroid, CentroidRadius()};
+  return TransformSphere(sphere, transform);
+}
 
-  double max_distance = 0.0;
-  for (const auto& vertex : vertices) {
-    double distance =
-        sqrt(pow(vertex[0], 2) + pow(vertex[1], 2) + pow(vertex[2], 2));
-    if (distance > max_distance) {
-      max_distance = distance;
+const MeshBounds& Model::Bounds() const {
+  if (!bounds) {
+    struct Partial {
+      std::array<double, 3> sum{};
+      BoundingBox box;
+      double radius2 = 0.0;
+    };
+    Partial identity;
+    identity.box.min.fill(HUGE_VAL);
+    identity.box.max.fill(-HUGE_VAL);
+    // Сумма, рамка и радиус от начала координат за один проход.
+    Partial total = ParallelReduce(
+        VertexPool(), SourceSize(), kVertexGrain, identity,
+        [this, &identity](std::size_t begin, std::size_t end) {
+          Partial local = identity;
+          std::vector<double> scratch;
+          const double* coords = SourceCoords(begin, end, scratch);
+          for (std::size_t i = 0; i < end - begin; i++) {
+            const double* vertex = coords + 3 * i;
+            for (int k = 0; k < 3; k++) {
+              local.sum[k] += vertex[k];
+              local.box.min[k] = std::min(local.box.min[k], vertex[k]);
+              local.box.max[k] = std::max(local.box.max[k], vertex[k]);
+            }
+            local.radius2 =
+                std::max(local.radius2, vertex[0] * vertex[0] +
+                                            vertex[1] * vertex[1] +
+                                            vertex[2] * vertex[2]);
+          }
+          return local;
+        },
+        [](Partial a, const Partial& b) {
+          for (int k = 0; k < 3; k++) {
+            a.sum[k] += b.sum[k];
+            a.box.min[k] = std::min(a.box.min[k], b.box.min[k]);
+            a.box.max[k] = std::max(a.box.max[k], b.box.max[k]);
+          }
+          a.radius2 = std::max(a.radius2, b.radius2);
+          return a;
+        });
+    MeshBounds result;
+    for (int k = 0; k < 3; k++) {
+      result.centroid[k] = total.sum[k] / SourceSize();
     }
+    result.box = total.box;
+    result.origin_radius = sqrt(total.radius2);
+    bounds = result;
   }
+  return *bounds;
+}
 
-  if (max_distance > 0.0) {
-    double scale = scale_factor / max_distance;
-    for (auto& vertex :
-         const_cast<std::vector<std::vector<double>>&>(vertices)) {
-      vertex[0] *= scale;
-      vertex[1] *= scale;
-      vertex[2] *= scale;
+double Model::CentroidRadius() const {
+  if (!centroid_radius) {
+    centroid_radius = sqrt(MaxDistance2(Transform::Translation(
+        -Bounds().centroid[0], -Bounds().centroid[1], -Bounds().centroid[2])));
+  }
+  return *centroid_radius;
+}
+
+double Model::MaxDistance2(const Transform& to) const {
+  return ParallelReduce(
+      VertexPool(), SourceSize(), kVertexGrain, 0.0,
+      [this, &to](std::size_t begin, std::size_t end) {
+        double local = 0.0;
+        std::vector<double> scratch;
+        const double* coords = SourceCoords(begin, end, scratch);
+        for (std::size_t i = 0; i < end - begin; i++) {
+          double vertex[3];
+          to.Apply(coords + 3 * i, vertex);
+          local = std::max(local, vertex[0] * vertex[0] +
+                                      vertex[1] * vertex[1] +
+                                      vertex[2] * vertex[2]);
+        }
+        return local;
+      },
+      [](double a, double b) { return std::max(a, b); });
+}
+
+double Model::FitRadius() {
+  if (!fit_radius) {
+    // При повороте с равномерным масштабом радиус берется из кэша, если
+    // начало координат или центр масс переходят в начало координат.
+    double scale = transform.UniformScale();
+    double center[3];
+    transform.Apply(Bounds().centroid.data(), center);
+    double offset = 0.0;
+    double diagonal = 0.0;
+    for (int k = 0; k < 3; k++) {
+      offset += center[k] * center[k];
+      double side = Bounds().box.max[k] - Bounds().box.min[k];
+      diagonal += side * side;
+    }
+    if (scale > 0.0 && !transform.HasTranslation()) {
+      fit_radius = scale * Bounds().origin_radius;
+    } else if (scale > 0.0 && sqrt(offset) <= 1e-12 * scale * sqrt(diagonal)) {
+      fit_radius = scale * CentroidRadius();
+    } else {
+      fit_radius = sqrt(MaxDistance2(transform));
+    }
+  }
+  return *fit_radius;
+}
+
+void Model::Compose(const Transform& step) {
+  transform = step * transform;
+  transformed_valid = false;
+  // Поворот и равномерный масштаб относительно начала координат меняют
+  // радиус предсказуемо, перенос — нет.
+  double scale = step.UniformScale();
+  if (fit_radius && scale > 0.0 && !step.HasTranslation()) {
+    *fit_radius *= scale;
+  } else {
+    fit_radius.reset();
+  }
+}
+
+void Model::GeometryChanged() {
+  geometry_version = NextGeometryVersion();
+  lods.clear();
+}
+
+LodTask Model::PrepareLods(const std::atomic<bool>* cancel) const {
+  // Здесь только копируются массивы в том виде, в каком они хранятся;
+  // раскодирование и упрощение идут в задаче.
+  auto source = std::make_shared<LodSource>();
+  if (compact.empty()) {
+    source->vertices = vertices;
+  } else {
+    source->compact = compact;
+  }
+  source->facets = facets;
+  std::uint64_t version = geometry_version;
+  std::vector<double> ratios = lod_ratios;
+  return [source, version, ratios, cancel]() {
+    LodChain chain;
+    chain.geometry_version = version;
+    chain.levels = SimplifyMesh(*source, ratios, cancel);
+    return chain;
+  };
+}
+
+bool Model::InstallLods(LodChain chain) {
+  if (chain.geometry_version != geometry_version) {
+    return false;
+  }
+  lods = std::move(chain.levels);
+  return true;
+}
+
+void Model::VerticesChanged() {
+  GeometryChanged();
+  transformed_valid = false;
+  bounds.reset();
+  centroid_radius.reset();
+  fit_radius.reset();
+}
+
+const VertexBuffer& Model::GetVertices() const {
+  if (transform.IsIdentity()) {
+    return GetSourceVertices();
+  }
+  if (!transformed_valid) {
+    transformed.Resize(SourceSize());
+    ParallelFor(VertexPool(), SourceSize(), kVertexGrain,
+                [this](std::size_t begin, std::size_t end) {
+                  if (compact.empty()) {
+                    TransformCoords(transform, vertices[begin],
+                                    transformed[begin], end - begin);
+                  } else {
+                    compact.Decode(begin, end - begin, transformed[begin],
+                                   transform);
+                  }
+                });
+    transformed_valid = true;
+  }
+  return transformed;
+}
+
+const VertexBuffer& Model::GetSourceVertices() const {
+  if (compact.empty() || !vertices.empty()) {
+    return vertices;
+  }
+  // Раскодированная копия держится, пока не изменятся вершины.
+  vertices.Resize(compact.size());
+  ParallelFor(VertexPool(), compact.size(), kVertexGrain,
+              [this](std::size_t begin, std::size_t end) {
+                compact.Decode(begin, end - begin, vertices[begin]);
+              });
+  return vertices;
+}
+
+std::size_t Model::GetBytesPerVertex() const {
+  return compact.empty() ? 3 * sizeof(double) : compact.BytesPerVertex();
+}
+
+std::size_t Model::SourceSize() const {
+  return compact.empty() ? vertices.size() : compact.size();
+}
+
+const double* Model::SourceCoords(std::size_t begin, std::size_t end,
+                                  std::vector<double>& scratch) const {
+  if (compact.empty()) {
+    return vertices[begin];
+  }
+  scratch.resize(3 * (end - begin));
+  compact.Decode(begin, end - begin, scratch.data());
+  return scratch.data();
+}
+
+void Model::Compact() {
+  compact.Encode(GetSourceVertices(), vertex_storage);
+  vertices.Assign(std::vector<double>());
+  VerticesChanged();
+}
+
+void Model::Expand() {
+  if (!compact.empty()) {
+    GetSourceVertices();
+    compact.Clear();
+  }
+}
+
+ThreadPool* Model::Pool() const {
+  unsigned threads =
+      load_threads > 0 ? load_threads : ThreadPool::DefaultThreads();
+  if (!pool || pool->Size() != threads) {
+    pool = std::make_shared<ThreadPool>(threads);
+  }
+  return pool.get();
+}
+
+ThreadPool* Model::VertexPool() const { return PoolFor(SourceSize()); }
+
+ThreadPool* Model::PoolFor(std::size_t items) const {
+  unsigned threads =
+      load_threads > 0 ? load_threads : ThreadPool::DefaultThreads();
+  if (threads < 2 || items < kParallelMinItems) {
+    return nullptr;
+  }
+  return Pool();
+}
+
+const std::vector<int>& Model::GetEdges() const {
+  if (!edges) {
+    edges = ExtractEdges(facets, PoolFor(facets.Indices().size()));
+  }
+  return *edges;
+}
+
+const std::vector<int>& Model::GetShuffledEdges() const {
+  if (!shuffled_edges) {
+    std::vector<int> shuffled = GetEdges();
+    std::mt19937 random(kShuffleSeed);
+    // Фишер — Йетс по парам индексов.
+    for (std::size_t i = shuffled.size() / 2; i > 1; i--) {
+      std::size_t j =
+          std::uniform_int_distribution<std::size_t>(0, i - 1)(random);
+      std::swap(shuffled[2 * (i - 1)], shuffled[2 * j]);
+      std::swap(shuffled[2 * (i - 1) + 1], shuffled[2 * j + 1]);
     }
+    shuffled_edges = std::move(shuffled);
+  }
+  return *shuffled_edges;
+}
+
+const Adjacency& Model::GetAdjacency() const {
+  if (!adjacency) {
+    adjacency = Adjacency::Build(facets, SourceSize(),
+                                 PoolFor(facets.Indices().size()));
+  }
+  return *adjacency;
+}
+
+void Model::TopologyChanged() {
+  GeometryChanged();
+  edges.reset();
+  shuffled_edges.reset();
+  adjacency.reset();
+}
+
+void Model::SetTransform(const Transform& new_transform) {
+  transform = new_transform;
+  transformed_valid = false;
+  fit_radius.reset();
+}
+
+void Model::SetVertices(std::vector<double> coords) {
+  if (coords.size() != 3 * SourceSize()) {
+    throw std::runtime_error("Vertex count mismatch");
+  }
+  bool compacted = !compact.empty();
+  compact.Clear();
+  vertices.Assign(std::move(coords));
+  VerticesChanged();
+  SetTransform(Transform());
+  if (compacted) {
+    Compact();
   }
 }
 
 void Model::ClearData() {
-  matrix_3d.clear();
-  polygons.clear();
+  ResetSource(std::string());
+  vertices.Clear();
+  facets.Clear();
   count_of_vertices = 0;
   count_of_facets = 0;
   rotation_x = 0.0;
@@ -1,54 +1,216 @@
 #ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_MODEL_H
 #define CPP4_S21_3DVIEWER_V2_SRC_MODEL_MODEL_H
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <cmath>
 #include <fstream>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "adjacency.h"
+#include "bounding_volume.h"
+#include "compact_vertices.h"
+#include "compressed_file.h"
+#include "edge_list.h"
+#include "facet_list.h"
+#include "lod.h"
+#include "mesh_cache.h"
+#include "mesh_cleanup.h"
+#include "obj_parser.h"
+#include "parallel_for.h"
+#include "thread_pool.h"
+#include "transform.h"
+#include "transform_kernel.h"
+#include "vertex_buffer.h"
+
 namespace s21 {
 
-struct Facet {
-  std::vector<int> vertices;
-  int count_vertices_in_facets;
+// Атрибуты вершин граней. Индексы в tex_indices и normal_indices идут в
+// порядке индексов вершин всех граней, начинаются с 1, 0 — атрибута нет.
+struct AttributeStreams {
+  std::vector<double> tex_coords;
+  std::vector<double> normals;
+  std::vector<int> tex_indices;
+  std::vector<int> normal_indices;
 };
 
+enum class LoadMode { kStream, kMapped, kParallel };
+
 class Model {
  public:
   Model();
   ~Model();
+  Model(Model&&) = default;
+  Model& operator=(Model&&) = default;
 
   void CountVerticesAndFacets(const std::string& file_path);
   void ParseModelData(const std::string& file_path);
+  void LoadModelData(const std::string& file_path);
   void RotateModel(double step, char xyz);
   void ApplyRotation();
   void MoveModel(double distance, char xyz);
+  // Применяет step после текущего преобразования.
+  void ApplyTransform(const Transform& step) { Compose(step); }
   void CenterModel();
   void ScaleModelToFit(double scale_factor);
+  // Центрирует модель и вписывает ее в сферу радиуса scale_factor.
+  void NormalizeModel(double scale_factor);
   void ClearData();
+  // Склеивает вершины и удаляет вырожденные и повторяющиеся грани.
+  void CleanupMesh();
+
+  void SetLoadMode(LoadMode mode) { load_mode = mode; }
+  LoadMode GetLoadMode() const { return load_mode; }
+  void SetLoadThreads(unsigned threads) { load_threads = threads; }
+  unsigned GetLoadThreads() const { return load_threads; }
+  void SetCacheEnabled(bool enabled) { cache_enabled = enabled; }
+  bool GetCacheEnabled() const { return cache_enabled; }
+  void SetCacheDirectory(const std::string& directory) {
+    cache_directory = directory;
+  }
+  const std::string& GetCacheDirectory() const { return cache_directory; }
+  void SetCleanupEnabled(bool enabled) { cleanup_enabled = enabled; }
+  bool GetCleanupEnabled() const { return cleanup_enabled; }
+  void SetWeldEpsilon(double epsilon) { weld_epsilon = epsilon; }
+  double GetWeldEpsilon() const { return weld_epsilon; }
+  const CleanupStats& GetCleanupStats() const { return cleanup_stats; }
+  // Хранение вершин после загрузки: double, float или 16-битные целые.
+  void SetVertexStorage(VertexStorage storage) { vertex_storage = storage; }
+  VertexStorage GetVertexStorage() const { return vertex_storage; }
+  // Сжатые вершины; пусто, если вершины хранятся в double.
+  const CompactVertices& GetCompactVertices() const { return compact; }
+  std::size_t GetBytesPerVertex() const;
+  double GetQuantizationError() const { return compact.MaxError(); }
+  void SetLoadControl(LoadControl control) {
+    load_control = std::move(control);
+  }
+  const LoadStats& GetLoadStats() const { return load_stats; }
+  // Текстурные координаты и нормали читаются из файла только по запросу.
+  const AttributeStreams& GetAttributes() const;
+  bool AttributesLoaded() const { return attributes != nullptr; }
 
   int GetVertexCount() const { return count_of_vertices; }
   int GetFacetCount() const { return count_of_facets; }
-  const std::vector<std::vector<double>>& GetMatrix3D() const {
-    return matrix_3d;
-  }
-  void SetMatrix3D(const std::vector<std::vector<double>>& matrix) {
-    matrix_3d = matrix;
+  // Координаты с примененным преобразованием, считаются при первом запросе.
+  const VertexBuffer& GetVertices() const;
+  // Координаты в том виде, в каком они загружены из файла. При сжатом
+  // хранении раскодируются при первом запросе.
+  const VertexBuffer& GetSourceVertices() const;
+  // Заменяет координаты, число вершин должно совпадать. Преобразование
+  // сбрасывается.
+  void SetVertices(std::vector<double> coords);
+  const Transform& GetTransform() const { return transform; }
+  // Рамка и сфера, содержащие модель с примененным преобразованием.
+  BoundingBox GetBoundingBox() const;
+  BoundingSphere GetBoundingSphere() const;
+  void SetTransform(const Transform& new_transform);
+  const FacetList& GetFacets() const { return facets; }
+  // Уникальные ребра парами индексов вершин; строятся при загрузке.
+  const std::vector<int>& GetEdges() const;
+  int GetEdgeCount() const { return static_cast<int>(GetEdges().size() / 2); }
+  // Те же ребра в случайном порядке: любое начало списка — равномерная
+  // выборка для грубого показа. Строится один раз на модель.
+  const std::vector<int>& GetShuffledEdges() const;
+  // Смежность вершин и граней. При включенном флаге строится при загрузке,
+  // иначе при первом запросе; преобразования ее не сбрасывают.
+  void SetAdjacencyEnabled(bool enabled) { adjacency_enabled = enabled; }
+  bool GetAdjacencyEnabled() const { return adjacency_enabled; }
+  const Adjacency& GetAdjacency() const;
+  bool AdjacencyBuilt() const { return adjacency.has_value(); }
+  // Меняется при любом изменении вершин или граней, но не преобразования.
+  // Отрисовка перезагружает буферы только при смене версии.
+  std::uint64_t GetGeometryVersion() const { return geometry_version; }
+  // Доли треугольников в упрощенных уровнях, по умолчанию 50%, 25%, 10%.
+  void SetLodRatios(std::vector<double> ratios) {
+    lod_ratios = std::move(ratios);
   }
-  const std::vector<Facet>& GetPolygons() const { return polygons; }
+  const std::vector<double>& GetLodRatios() const { return lod_ratios; }
+  // Задача построения уровней над копией геометрии, ее можно выполнять в
+  // другом потоке. Исходная модель остается основой для преобразований,
+  // рамок и сохранения.
+  LodTask PrepareLods(const std::atomic<bool>* cancel = nullptr) const;
+  // Принимает уровни, если геометрия с начала построения не менялась.
+  bool InstallLods(LodChain chain);
+  const std::vector<LodLevel>& GetLods() const { return lods; }
 
  private:
-  void RotatePoint(std::vector<double>& point, double angle, char xyz);
+  void LoadCachedData(const std::string& file_path);
+  void ParseStreamData(const std::string& file_path);
+  void ParseMappedData(const std::string& file_path);
+  void ParseCompressedData(const std::string& file_path);
+  void ParseMappedRange(const char* begin, const char* end);
+  void ParseParallelData(const std::string& file_path);
+  void StitchChunks(const std::vector<obj::ObjChunk>& chunks);
+  void ResetSource(const std::string& file_path);
+  void ReadMeshArrays(const MeshArrays& mesh);
+  bool StoreMeshCache(const MeshCache& cache, const std::string& file_path,
+                      const CacheKey& key) const;
+  void Compose(const Transform& step);
+  void GeometryChanged();
+  void VerticesChanged();
+  std::size_t SourceSize() const;
+  // Координаты вершин [begin, end): прямо из буфера или раскодированные в
+  // scratch.
+  const double* SourceCoords(std::size_t begin, std::size_t end,
+                             std::vector<double>& scratch) const;
+  void Compact();
+  void Expand();
+  const MeshBounds& Bounds() const;
+  double CentroidRadius() const;
+  // Квадрат наибольшего расстояния до начала координат после to.
+  double MaxDistance2(const Transform& to) const;
+  // Наибольшее расстояние вершины от начала координат после transform.
+  double FitRadius();
+  // Общий пул для разбора и проходов по вершинам.
+  ThreadPool* Pool() const;
+  // Пул для прохода по вершинам или nullptr, если модель мала.
+  ThreadPool* VertexPool() const;
+  ThreadPool* PoolFor(std::size_t items) const;
+  void TopologyChanged();
 
   int count_of_vertices = 0;
   int count_of_facets = 0;
-  std::vector<std::vector<double>> matrix_3d;
-  std::vector<Facet> polygons;
+  mutable VertexBuffer vertices;
+  CompactVertices compact;
+  VertexStorage vertex_storage = VertexStorage::kDouble;
+  FacetList facets;
+  mutable std::optional<std::vector<int>> edges;
+  mutable std::optional<std::vector<int>> shuffled_edges;
+  mutable std::optional<Adjacency> adjacency;
+  bool adjacency_enabled = false;
+  std::uint64_t geometry_version = 0;
+  std::vector<double> lod_ratios{0.5, 0.25, 0.1};
+  std::vector<LodLevel> lods;
+  // Все повороты, переносы и масштабирования после загрузки.
+  Transform transform;
+  mutable VertexBuffer transformed;
+  mutable bool transformed_valid = false;
+  mutable std::optional<MeshBounds> bounds;
+  mutable std::optional<double> centroid_radius;
+  std::optional<double> fit_radius;
   double rotation_x;
   double rotation_y;
   double rotation_z;
+  LoadMode load_mode = LoadMode::kParallel;
+  unsigned load_threads = 0;
+  bool cache_enabled = false;
+  std::string cache_directory;
+  LoadControl load_control;
+  LoadStats load_stats;
+  mutable std::shared_ptr<ThreadPool> pool;
+  std::string source_path;
+  mutable std::unique_ptr<AttributeStreams> attributes;
+  bool cleanup_enabled = false;
+  double weld_epsilon = 0.0;
+  CleanupStats cleanup_stats;
+  // Номера углов граней исходного файла, оставшихся после очистки.
+  std::optional<std::vector<int>> kept_corners;
 };
 
 }  // namespace s21
@@ -0,0 +1,133 @@
+#include "obj_parser.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <charconv>
+
+namespace s21 {
+
+MappedFile::MappedFile(const std::string& file_path) {
+  int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open file");
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    throw std::runtime_error("Failed to open file");
+  }
+  length = static_cast<std::size_t>(info.st_size);
+  if (length > 0) {
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Failed to map file");
+    }
+    ::madvise(mapped, length, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapped);
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data) {
+    ::munmap(const_cast<char*>(data), length);
+  }
+}
+
+void LoadProgress::Advance(std::size_t bytes) {
+  std::size_t current = done.fetch_add(bytes) + bytes;
+  if (control.Cancelled()) {
+    throw LoadCancelled();
+  }
+  if (control.progress) {
+    control.progress(current, total);
+  }
+}
+
+namespace obj {
+
+bool ParseDouble(const char*& p, const char* end, double& value) {
+  const char* first = SkipSpaces(p, end);
+  if (first < end && *first == '+') {
+    first++;
+  }
+  auto result = std::from_chars(first, end, value);
+  if (result.ec != std::errc()) {
+    return false;
+  }
+  p = result.ptr;
+  return true;
+}
+
+bool ParseIndex(const char*& p, const char* end, int& value) {
+  const char* first = p;
+  if (first < end && *first == '+') {
+    first++;
+  }
+  auto result = std::from_chars(first, end, value);
+  if (result.ec != std::errc()) {
+    return false;
+  }
+  p = result.ptr;
+  return true;
+}
+
+bool ParseFacetToken(const char*& p, const char* end, int& vertex,
+                     int* texture, int* normal) {
+  if (!ParseIndex(p, end, vertex)) {
+    return false;
+  }
+  int texture_index = 0;
+  int normal_index = 0;
+  if (p < end && *p == '/') {
+    p++;
+    if ((p == end || *p != '/') && !ParseIndex(p, end, texture_index)) {
+      return false;
+    }
+    if (p < end && *p == '/') {
+      p++;
+      if (!ParseIndex(p, end, normal_index)) {
+        return false;
+      }
+    }
+  }
+  if (p < end && !IsSpace(*p)) {
+    return false;
+  }
+  if (texture) {
+    *texture = texture_index;
+  }
+  if (normal) {
+    *normal = normal_index;
+  }
+  return true;
+}
+
+std::vector<std::pair<const char*, const char*>> SplitLines(const char* begin,
+                                                             const char* end,
+                                                             std::size_t parts) {
+  std::vector<std::pair<const char*, const char*>> ranges;
+  std::size_t size = end - begin;
+  const char* first = begin;
+  for (std::size_t i = 1; i <= parts && first < end; i++) {
+    const char* last = i == parts ? end : begin + size * i / parts;
+    if (last < first) {
+      last = first;
+    }
+    if (last < end) {
+      last = FindLineEnd(last, end);
+      last = last < end ? last + 1 : end;
+    }
+    ranges.emplace_back(first, last);
+    first = last;
+  }
+  return ranges;
+}
+
+}  // namespace obj
+
+}  // namespace s21
@@ -0,0 +1,274 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_OBJ_PARSER_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_OBJ_PARSER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_path);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* begin() const { return data; }
+  const char* end() const { return data + length; }
+  std::size_t size() const { return length; }
+
+ private:
+  const char* data = nullptr;
+  std::size_t length = 0;
+};
+
+struct LoadStats {
+  std::size_t bytes = 0;
+  double seconds = 0.0;
+  bool from_cache = false;
+
+  double MegabytesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(bytes) / 1e6 / seconds : 0.0;
+  }
+};
+
+// Часть геометрии, прочитанная с момента предыдущей публикации.
+struct LoadBatch {
+  int first_vertex = 0;
+  std::vector<double> coords;
+  std::vector<int> indices;
+  std::vector<int> facet_sizes;
+};
+
+struct LoadControl {
+  std::function<void(std::size_t, std::size_t)> progress;
+  std::function<void(LoadBatch&&)> batch;
+  std::chrono::milliseconds batch_interval{100};
+  const std::atomic<bool>* cancel = nullptr;
+
+  bool Cancelled() const {
+    return cancel && cancel->load(std::memory_order_relaxed);
+  }
+};
+
+class LoadCancelled : public std::runtime_error {
+ public:
+  LoadCancelled() : std::runtime_error("Loading cancelled") {}
+};
+
+// Счетчик прочитанных байт, общий для всех потоков загрузки.
+class LoadProgress {
+ public:
+  LoadProgress(const LoadControl& control, std::size_t total)
+      : control(control), total(total) {}
+
+  void Advance(std::size_t bytes);
+
+ private:
+  const LoadControl& control;
+  std::size_t total;
+  std::atomic<std::size_t> done{0};
+};
+
+namespace obj {
+
+constexpr std::size_t kProgressBlockBytes = 1 << 20;
+
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+  while (p < end && IsSpace(*p)) {
+    p++;
+  }
+  return p;
+}
+
+inline const char* FindLineEnd(const char* p, const char* end) {
+  const void* found = std::memchr(p, '\n', end - p);
+  return found ? static_cast<const char*>(found) : end;
+}
+
+// Разбор числа с той же семантикой префикса, что и у operator>>.
+bool ParseDouble(const char*& p, const char* end, double& value);
+bool ParseIndex(const char*& p, const char* end, int& value);
+
+// Разбирает токен грани v, v/vt, v//vn или v/vt/vn. Отсутствующие индексы
+// текстуры и нормали возвращаются как 0. Если texture и normal равны
+// nullptr, атрибуты только проверяются и не сохраняются.
+bool ParseFacetToken(const char*& p, const char* end, int& vertex,
+                     int* texture = nullptr, int* normal = nullptr);
+
+template <class Sink>
+void ParseVertexLine(const char* p, const char* end, Sink& sink) {
+  double coords[3] = {0.0, 0.0, 0.0};
+  int count = 0;
+  double coord = 0.0;
+  while (ParseDouble(p, end, coord)) {
+    if (count == 3) {
+      count++;
+      break;
+    }
+    coords[count++] = coord;
+  }
+  if (count != 3) {
+    throw std::runtime_error("Each vertex must have exactly 3 coordinates");
+  }
+  sink.OnVertex(coords[0], coords[1], coords[2]);
+}
+
+template <class Sink>
+void ParseFacetLine(const char* p, const char* end, Sink& sink) {
+  int count = 0;
+  for (p = SkipSpaces(p, end); p < end; p = SkipSpaces(p, end)) {
+    int index = 0;
+    if (!ParseFacetToken(p, end, index)) {
+      throw std::runtime_error("Invalid facet token");
+    }
+    sink.OnFacetIndex(index);
+    count++;
+  }
+  sink.OnFacetEnd(count);
+}
+
+template <class Sink>
+void ParseTexCoordLine(const char* p, const char* end, Sink& sink) {
+  double coords[3] = {0.0, 0.0, 0.0};
+  int count = 0;
+  double coord = 0.0;
+  while (count < 4 && ParseDouble(p, end, coord)) {
+    if (count < 3) {
+      coords[count] = coord;
+    }
+    count++;
+  }
+  if (count < 1 || count > 3) {
+    throw std::runtime_error("Texture coordinate must have 1 to 3 values");
+  }
+  sink.OnTexCoord(coords[0], coords[1]);
+}
+
+template <class Sink>
+void ParseNormalLine(const char* p, const char* end, Sink& sink) {
+  double coords[3] = {0.0, 0.0, 0.0};
+  int count = 0;
+  double coord = 0.0;
+  while (count < 4 && ParseDouble(p, end, coord)) {
+    if (count < 3) {
+      coords[count] = coord;
+    }
+    count++;
+  }
+  if (count != 3) {
+    throw std::runtime_error("Each normal must have exactly 3 coordinates");
+  }
+  sink.OnNormal(coords[0], coords[1], coords[2]);
+}
+
+template <class Sink>
+void ParseAttributeFacetLine(const char* p, const char* end, Sink& sink) {
+  for (p = SkipSpaces(p, end); p < end; p = SkipSpaces(p, end)) {
+    int index = 0;
+    int texture = 0;
+    int normal = 0;
+    if (!ParseFacetToken(p, end, index, &texture, &normal)) {
+      throw std::runtime_error("Invalid facet token");
+    }
+    sink.OnFacetToken(texture, normal);
+  }
+}
+
+// Строки одного куска файла без разрешения индексов. Для каждой строки
+// граней запоминается число вершин, прочитанных в куске до неё.
+struct ObjChunk {
+  static constexpr bool kAttributes = false;
+
+  std::vector<double> coords;
+  std::vector<int> indices;
+  std::vector<int> line_offsets{0};
+  std::vector<int> line_marks;
+  std::exception_ptr error;
+
+  int VertexCount() const { return static_cast<int>(coords.size() / 3); }
+  int LineCount() const { return static_cast<int>(line_marks.size()); }
+
+  void OnVertex(double x, double y, double z) {
+    coords.push_back(x);
+    coords.push_back(y);
+    coords.push_back(z);
+  }
+  void OnFacetIndex(int index) { indices.push_back(index); }
+  void OnFacetEnd(int) {
+    line_offsets.push_back(static_cast<int>(indices.size()));
+    line_marks.push_back(VertexCount());
+  }
+  void OnBlockEnd() {}
+};
+
+std::vector<std::pair<const char*, const char*>> SplitLines(const char* begin,
+                                                             const char* end,
+                                                             std::size_t parts);
+
+// Разбирает диапазон целых строк [begin, end) без выделения памяти.
+// Приемник с kAttributes == false получает только геометрию: строки vt и vn
+// пропускаются, а в токенах граней атрибуты лишь проверяются. Приемник
+// атрибутов, наоборот, получает только vt, vn и индексы атрибутов граней.
+template <class Sink>
+void ParseLines(const char* begin, const char* end, Sink& sink) {
+  for (const char* line = begin; line < end;) {
+    const char* line_end = FindLineEnd(line, end);
+    if (line_end - line >= 2 && line[1] == ' ') {
+      if (line[0] == 'v') {
+        if constexpr (!Sink::kAttributes) {
+          ParseVertexLine(line + 2, line_end, sink);
+        }
+      } else if (line[0] == 'f') {
+        if constexpr (Sink::kAttributes) {
+          ParseAttributeFacetLine(line + 2, line_end, sink);
+        } else {
+          ParseFacetLine(line + 2, line_end, sink);
+        }
+      }
+    } else if constexpr (Sink::kAttributes) {
+      if (line_end - line >= 3 && line[0] == 'v' && line[2] == ' ') {
+        if (line[1] == 't') {
+          ParseTexCoordLine(line + 3, line_end, sink);
+        } else if (line[1] == 'n') {
+          ParseNormalLine(line + 3, line_end, sink);
+        }
+      }
+    }
+    line = line_end + 1;
+  }
+}
+
+template <class Sink>
+void ParseLines(const char* begin, const char* end, Sink& sink,
+                LoadProgress& progress) {
+  while (begin < end) {
+    const char* block_end = end;
+    if (static_cast<std::size_t>(end - begin) > kProgressBlockBytes) {
+      block_end = FindLineEnd(begin + kProgressBlockBytes, end);
+      block_end = block_end < end ? block_end + 1 : end;
+    }
+    ParseLines(begin, block_end, sink);
+    progress.Advance(block_end - begin);
+    sink.OnBlockEnd();
+    begin = block_end;
+  }
+}
+
+}  // namespace obj
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_OBJ_PARSER_H
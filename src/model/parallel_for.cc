@@ -0,0 +1,151 @@
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace s21 {
+
+namespace {
+
+// Очередь кусков одного участника: [front, back) в одном слове, чтобы
+// владелец (с начала) и воры (с конца) разбирали ее одной операцией CAS.
+struct alignas(64) ChunkQueue {
+  std::atomic<std::uint64_t> range{0};
+
+  static std::uint64_t Pack(std::uint32_t front, std::uint32_t back) {
+    return (static_cast<std::uint64_t>(front) << 32) | back;
+  }
+
+  bool PopFront(std::size_t& chunk) {
+    std::uint64_t current = range.load();
+    while (true) {
+      std::uint32_t front = static_cast<std::uint32_t>(current >> 32);
+      std::uint32_t back = static_cast<std::uint32_t>(current);
+      if (front >= back) {
+        return false;
+      }
+      if (range.compare_exchange_weak(current, Pack(front + 1, back))) {
+        chunk = front;
+        return true;
+      }
+    }
+  }
+
+  bool PopBack(std::size_t& chunk) {
+    std::uint64_t current = range.load();
+    while (true) {
+      std::uint32_t front = static_cast<std::uint32_t>(current >> 32);
+      std::uint32_t back = static_cast<std::uint32_t>(current);
+      if (front >= back) {
+        return false;
+      }
+      if (range.compare_exchange_weak(current, Pack(front, back - 1))) {
+        chunk = back - 1;
+        return true;
+      }
+    }
+  }
+};
+
+struct ParallelState {
+  ParallelState(std::size_t participants, std::size_t chunks)
+      : queues(new ChunkQueue[participants]), participants(participants) {
+    for (std::size_t i = 0; i < participants; i++) {
+      queues[i].range = ChunkQueue::Pack(
+          static_cast<std::uint32_t>(chunks * i / participants),
+          static_cast<std::uint32_t>(chunks * (i + 1) / participants));
+    }
+  }
+
+  bool Next(std::size_t own, std::size_t& chunk) {
+    if (queues[own].PopFront(chunk)) {
+      return true;
+    }
+    for (std::size_t i = 1; i < participants; i++) {
+      if (queues[(own + i) % participants].PopBack(chunk)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::unique_ptr<ChunkQueue[]> queues;
+  std::size_t participants;
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  // Вызывающий поток ждет только помощников, успевших начать работу.
+  std::mutex mutex;
+  std::condition_variable idle;
+  std::size_t active = 0;
+  bool closed = false;
+};
+
+void RunChunks(ParallelState& state, std::size_t own, std::size_t count,
+               std::size_t grain, const RangeTask& body) {
+  std::size_t chunk = 0;
+  while (!state.failed.load() && state.Next(own, chunk)) {
+    try {
+      body(chunk * grain, std::min(count, (chunk + 1) * grain));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (!state.error) {
+        state.error = std::current_exception();
+      }
+      state.failed = true;
+    }
+  }
+}
+
+}  // namespace
+
+void ParallelFor(ThreadPool* pool, std::size_t count, std::size_t grain,
+                 const RangeTask& body) {
+  if (grain == 0) {
+    grain = 1;
+  }
+  std::size_t chunks = (count + grain - 1) / grain;
+  std::size_t helpers = pool ? std::min<std::size_t>(pool->Size(), chunks - 1)
+                             : 0;
+  if (chunks < 2 || helpers == 0) {
+    for (std::size_t begin = 0; begin < count; begin += grain) {
+      body(begin, std::min(count, begin + grain));
+    }
+    return;
+  }
+  auto state = std::make_shared<ParallelState>(helpers + 1, chunks);
+  for (std::size_t i = 1; i <= helpers; i++) {
+    // Задача может начаться после выхода из ParallelFor и тогда ничего не
+    // делает: body к этому моменту уже недоступен.
+    pool->Submit([state, i, count, grain, &body] {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->closed) {
+          return;
+        }
+        state->active++;
+      }
+      RunChunks(*state, i, count, grain, body);
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->active--;
+      }
+      state->idle.notify_all();
+    });
+  }
+  RunChunks(*state, 0, count, grain, body);
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->closed = true;
+    state->idle.wait(lock, [&state] { return state->active == 0; });
+  }
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+}  // namespace s21
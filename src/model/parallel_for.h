@@ -0,0 +1,44 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_PARALLEL_FOR_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_PARALLEL_FOR_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace s21 {
+
+using RangeTask = std::function<void(std::size_t begin, std::size_t end)>;
+
+// Делит [0, count) на куски по grain элементов и выполняет body для каждого
+// куска. Куски заранее распределяются между вызывающим потоком и потоками
+// пула; освободившийся поток забирает куски с конца чужой очереди. Без пула
+// куски выполняются по порядку в вызывающем потоке. Исключение из body
+// передается вызывающему.
+void ParallelFor(ThreadPool* pool, std::size_t count, std::size_t grain,
+                 const RangeTask& body);
+
+// Свертка по тем же кускам: map(begin, end) дает частичный результат куска,
+// combine объединяет их строго в порядке кусков. Поэтому результат не
+// зависит от числа потоков и от того, кто какой кусок выполнил.
+template <class T, class Map, class Combine>
+T ParallelReduce(ThreadPool* pool, std::size_t count, std::size_t grain,
+                 T identity, Map map, Combine combine) {
+  if (grain == 0) {
+    grain = 1;
+  }
+  std::vector<T> partials((count + grain - 1) / grain, identity);
+  ParallelFor(pool, count, grain, [&](std::size_t begin, std::size_t end) {
+    partials[begin / grain] = map(begin, end);
+  });
+  T result = identity;
+  for (const T& partial : partials) {
+    result = combine(result, partial);
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_PARALLEL_FOR_H
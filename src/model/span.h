@@ -0,0 +1,29 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_SPAN_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_SPAN_H
+
+#include <cstddef>
+
+namespace s21 {
+
+// Непрерывный диапазон элементов без владения памятью (аналог std::span).
+template <class T>
+class Span {
+ public:
+  Span() = default;
+  Span(T* data, std::size_t size) : first(data), count(size) {}
+
+  T* begin() const { return first; }
+  T* end() const { return first + count; }
+  T* data() const { return first; }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  T& operator[](std::size_t i) const { return first[i]; }
+
+ private:
+  T* first = nullptr;
+  std::size_t count = 0;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_SPAN_H
@@ -0,0 +1,47 @@
+#include "thread_pool.h"
+
+namespace s21 {
+
+ThreadPool::ThreadPool(unsigned threads) {
+  if (threads == 0) {
+    threads = 1;
+  }
+  workers.reserve(threads);
+  for (unsigned i = 0; i < threads; i++) {
+    workers.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  ready.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+unsigned ThreadPool::DefaultThreads() {
+  unsigned threads = std::thread::hardware_concurrency();
+  return threads > 0 ? threads : 1;
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (stopping && tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,51 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_THREAD_POOL_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+class ThreadPool {
+ public:
+  explicit ThreadPool(unsigned threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  unsigned Size() const { return static_cast<unsigned>(workers.size()); }
+
+  template <class Task>
+  std::future<void> Submit(Task&& task) {
+    auto packaged = std::make_shared<std::packaged_task<void()>>(
+        std::forward<Task>(task));
+    std::future<void> result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.emplace_back([packaged] { (*packaged)(); });
+    }
+    ready.notify_one();
+    return result;
+  }
+
+  static unsigned DefaultThreads();
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable ready;
+  bool stopping = false;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_THREAD_POOL_H
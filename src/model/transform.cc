@@ -0,0 +1,130 @@
+#include "transform.h"
+
+#include <cmath>
+
+namespace s21 {
+
+Transform::Transform() : m{} {
+  for (int i = 0; i < 4; i++) {
+    Element(i, i) = 1.0;
+  }
+}
+
+Transform Transform::Rotation(char axis, double angle) {
+  Transform rotation;
+  if (axis != 'x' && axis != 'y' && axis != 'z') {
+    return rotation;
+  }
+  double cos_result = cos(angle);
+  double sin_result = sin(angle);
+  // Плоскость поворота: (y, z) для x, (z, x) для y, (x, y) для z.
+  int first = axis == 'x' ? 1 : axis == 'y' ? 2 : 0;
+  int second = axis == 'x' ? 2 : axis == 'y' ? 0 : 1;
+  rotation.Element(first, first) = cos_result;
+  rotation.Element(first, second) = -sin_result;
+  rotation.Element(second, first) = sin_result;
+  rotation.Element(second, second) = cos_result;
+  return rotation;
+}
+
+Transform Transform::Translation(double x, double y, double z) {
+  Transform translation;
+  translation.Element(0, 3) = x;
+  translation.Element(1, 3) = y;
+  translation.Element(2, 3) = z;
+  return translation;
+}
+
+Transform Transform::Scaling(double factor) {
+  return Scaling(factor, factor, factor);
+}
+
+Transform Transform::Scaling(double x, double y, double z) {
+  Transform scaling;
+  scaling.Element(0, 0) = x;
+  scaling.Element(1, 1) = y;
+  scaling.Element(2, 2) = z;
+  return scaling;
+}
+
+Transform Transform::operator*(const Transform& other) const {
+  Transform result;
+  for (int row = 0; row < 4; row++) {
+    for (int column = 0; column < 4; column++) {
+      double sum = 0.0;
+      for (int k = 0; k < 4; k++) {
+        sum += At(row, k) * other.At(k, column);
+      }
+      result.Element(row, column) = sum;
+    }
+  }
+  return result;
+}
+
+Transform Transform::Inverse() const {
+  // Обратная к линейной части через алгебраические дополнения.
+  double cofactor[3][3];
+  for (int row = 0; row < 3; row++) {
+    for (int column = 0; column < 3; column++) {
+      int r1 = (row + 1) % 3;
+      int r2 = (row + 2) % 3;
+      int c1 = (column + 1) % 3;
+      int c2 = (column + 2) % 3;
+      cofactor[row][column] =
+          At(r1, c1) * At(r2, c2) - At(r1, c2) * At(r2, c1);
+    }
+  }
+  double determinant = At(0, 0) * cofactor[0][0] +
+                       At(0, 1) * cofactor[0][1] + At(0, 2) * cofactor[0][2];
+  Transform inverse;
+  if (determinant == 0.0) {
+    return inverse;
+  }
+  for (int row = 0; row < 3; row++) {
+    for (int column = 0; column < 3; column++) {
+      inverse.Element(row, column) = cofactor[column][row] / determinant;
+    }
+  }
+  for (int row = 0; row < 3; row++) {
+    inverse.Element(row, 3) =
+        -(inverse.At(row, 0) * At(0, 3) + inverse.At(row, 1) * At(1, 3) +
+          inverse.At(row, 2) * At(2, 3));
+  }
+  return inverse;
+}
+
+void Transform::Apply(const double* point, double* result) const {
+  double x = point[0];
+  double y = point[1];
+  double z = point[2];
+  for (int row = 0; row < 3; row++) {
+    result[row] =
+        At(row, 0) * x + At(row, 1) * y + At(row, 2) * z + At(row, 3);
+  }
+}
+
+bool Transform::IsIdentity() const { return *this == Transform(); }
+
+double Transform::UniformScale() const {
+  // Столбцы линейной части должны быть попарно ортогональны и одной длины.
+  double gram[3][3];
+  for (int a = 0; a < 3; a++) {
+    for (int b = 0; b < 3; b++) {
+      gram[a][b] = At(0, a) * At(0, b) + At(1, a) * At(1, b) +
+                   At(2, a) * At(2, b);
+    }
+  }
+  double scale2 = (gram[0][0] + gram[1][1] + gram[2][2]) / 3;
+  double tolerance = 1e-9 * scale2;
+  for (int a = 0; a < 3; a++) {
+    for (int b = 0; b < 3; b++) {
+      double expected = a == b ? scale2 : 0.0;
+      if (std::fabs(gram[a][b] - expected) > tolerance) {
+        return 0.0;
+      }
+    }
+  }
+  return std::sqrt(scale2);
+}
+
+}  // namespace s21
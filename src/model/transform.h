@@ -0,0 +1,49 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_TRANSFORM_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_TRANSFORM_H
+
+#include <array>
+
+namespace s21 {
+
+// Аффинное преобразование 4x4. Элементы хранятся по столбцам, как их
+// ожидает glMultMatrixd.
+class Transform {
+ public:
+  Transform();
+  explicit Transform(const std::array<double, 16>& elements)
+      : m(elements) {}
+
+  // Поворот вокруг оси 'x', 'y' или 'z' в направлении RotatePoint.
+  static Transform Rotation(char axis, double angle);
+  static Transform Translation(double x, double y, double z);
+  static Transform Scaling(double factor);
+  static Transform Scaling(double x, double y, double z);
+
+  // Композиция: сначала other, затем this.
+  Transform operator*(const Transform& other) const;
+  bool operator==(const Transform& other) const { return m == other.m; }
+  // Обратное аффинное преобразование; для вырожденного — тождественное.
+  Transform Inverse() const;
+
+  void Apply(const double* point, double* result) const;
+  bool IsIdentity() const;
+  // Множитель масштаба, если линейная часть — поворот с равномерным
+  // масштабом, иначе 0.
+  double UniformScale() const;
+  bool HasTranslation() const {
+    return At(0, 3) != 0.0 || At(1, 3) != 0.0 || At(2, 3) != 0.0;
+  }
+
+  double At(int row, int column) const { return m[column * 4 + row]; }
+  const double* Data() const { return m.data(); }
+  const std::array<double, 16>& Elements() const { return m; }
+
+ private:
+  double& Element(int row, int column) { return m[column * 4 + row]; }
+
+  std::array<double, 16> m;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_TRANSFORM_H
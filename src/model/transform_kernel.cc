@@ -0,0 +1,182 @@
+#include "transform_kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define S21_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+// Столбцы линейной части и перенос: out = c0 * x + c1 * y + c2 * z + t.
+struct AffineColumns {
+  double c0[4];
+  double c1[4];
+  double c2[4];
+  double t[4];
+};
+
+AffineColumns ColumnsOf(const Transform& transform) {
+  AffineColumns columns;
+  for (int row = 0; row < 4; row++) {
+    columns.c0[row] = transform.At(row, 0);
+    columns.c1[row] = transform.At(row, 1);
+    columns.c2[row] = transform.At(row, 2);
+    columns.t[row] = transform.At(row, 3);
+  }
+  return columns;
+}
+
+void ScalarKernel(const AffineColumns& m, const double* in, double* out,
+                  std::size_t count) {
+  for (std::size_t i = 0; i < count; i++, in += 3, out += 3) {
+    double x = in[0];
+    double y = in[1];
+    double z = in[2];
+    for (int row = 0; row < 3; row++) {
+      double product = m.c0[row] * x;
+      product += m.c1[row] * y;
+      product += m.c2[row] * z;
+      out[row] = product + m.t[row];
+    }
+  }
+}
+
+#ifdef S21_X86_KERNELS
+
+// x и y вершины считаются в одном регистре, z — скалярно.
+__attribute__((target("sse2"))) void Sse2Kernel(const AffineColumns& m,
+                                                const double* in, double* out,
+                                                std::size_t count) {
+  __m128d c0 = _mm_loadu_pd(m.c0);
+  __m128d c1 = _mm_loadu_pd(m.c1);
+  __m128d c2 = _mm_loadu_pd(m.c2);
+  __m128d t = _mm_loadu_pd(m.t);
+  __m128d c0z = _mm_set_sd(m.c0[2]);
+  __m128d c1z = _mm_set_sd(m.c1[2]);
+  __m128d c2z = _mm_set_sd(m.c2[2]);
+  __m128d tz = _mm_set_sd(m.t[2]);
+  for (std::size_t i = 0; i < count; i++, in += 3, out += 3) {
+    __m128d x = _mm_set1_pd(in[0]);
+    __m128d y = _mm_set1_pd(in[1]);
+    __m128d z = _mm_set1_pd(in[2]);
+    __m128d xy = _mm_mul_pd(c0, x);
+    xy = _mm_add_pd(xy, _mm_mul_pd(c1, y));
+    xy = _mm_add_pd(xy, _mm_mul_pd(c2, z));
+    xy = _mm_add_pd(xy, t);
+    __m128d zz = _mm_mul_sd(c0z, x);
+    zz = _mm_add_sd(zz, _mm_mul_sd(c1z, y));
+    zz = _mm_add_sd(zz, _mm_mul_sd(c2z, z));
+    zz = _mm_add_sd(zz, tz);
+    _mm_storeu_pd(out, xy);
+    _mm_store_sd(out + 2, zz);
+  }
+}
+
+// Четыре вершины за итерацию: 12 чисел читаются тремя регистрами и
+// раскладываются в столбцы x, y, z (дорожки 0-1 — вершины 0 и 1, дорожки
+// 2-3 — вершины 2 и 3), считаются через FMA и собираются обратно.
+__attribute__((target("avx2,fma"))) void Avx2Kernel(const AffineColumns& m,
+                                                    const double* in,
+                                                    double* out,
+                                                    std::size_t count) {
+  __m256d m00 = _mm256_set1_pd(m.c0[0]);
+  __m256d m01 = _mm256_set1_pd(m.c1[0]);
+  __m256d m02 = _mm256_set1_pd(m.c2[0]);
+  __m256d m03 = _mm256_set1_pd(m.t[0]);
+  __m256d m10 = _mm256_set1_pd(m.c0[1]);
+  __m256d m11 = _mm256_set1_pd(m.c1[1]);
+  __m256d m12 = _mm256_set1_pd(m.c2[1]);
+  __m256d m13 = _mm256_set1_pd(m.t[1]);
+  __m256d m20 = _mm256_set1_pd(m.c0[2]);
+  __m256d m21 = _mm256_set1_pd(m.c1[2]);
+  __m256d m22 = _mm256_set1_pd(m.c2[2]);
+  __m256d m23 = _mm256_set1_pd(m.t[2]);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4, in += 12, out += 12) {
+    __m256d a = _mm256_loadu_pd(in);      // x0 y0 z0 x1
+    __m256d b = _mm256_loadu_pd(in + 4);  // y1 z1 x2 y2
+    __m256d c = _mm256_loadu_pd(in + 8);  // z2 x3 y3 z3
+    __m256d p = _mm256_permute2f128_pd(a, b, 0x30);  // x0 y0 x2 y2
+    __m256d q = _mm256_permute2f128_pd(a, c, 0x21);  // z0 x1 z2 x3
+    __m256d r = _mm256_permute2f128_pd(b, c, 0x30);  // y1 z1 y3 z3
+    __m256d x = _mm256_shuffle_pd(p, q, 0xA);
+    __m256d y = _mm256_shuffle_pd(p, r, 0x5);
+    __m256d z = _mm256_shuffle_pd(q, r, 0xA);
+    __m256d ox = _mm256_mul_pd(m00, x);
+    ox = _mm256_fmadd_pd(m01, y, ox);
+    ox = _mm256_fmadd_pd(m02, z, ox);
+    ox = _mm256_add_pd(ox, m03);
+    __m256d oy = _mm256_mul_pd(m10, x);
+    oy = _mm256_fmadd_pd(m11, y, oy);
+    oy = _mm256_fmadd_pd(m12, z, oy);
+    oy = _mm256_add_pd(oy, m13);
+    __m256d oz = _mm256_mul_pd(m20, x);
+    oz = _mm256_fmadd_pd(m21, y, oz);
+    oz = _mm256_fmadd_pd(m22, z, oz);
+    oz = _mm256_add_pd(oz, m23);
+    p = _mm256_unpacklo_pd(ox, oy);
+    q = _mm256_shuffle_pd(oz, ox, 0xA);
+    r = _mm256_unpackhi_pd(oy, oz);
+    _mm256_storeu_pd(out, _mm256_permute2f128_pd(p, q, 0x20));
+    _mm256_storeu_pd(out + 4, _mm256_permute2f128_pd(r, p, 0x30));
+    _mm256_storeu_pd(out + 8, _mm256_permute2f128_pd(q, r, 0x31));
+  }
+  ScalarKernel(m, in, out, count - i);
+}
+
+#endif
+
+}  // namespace
+
+bool KernelSupported(TransformKernel kernel) {
+#ifdef S21_X86_KERNELS
+  switch (kernel) {
+    case TransformKernel::kAvx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case TransformKernel::kSse2:
+      return __builtin_cpu_supports("sse2");
+    default:
+      return true;
+  }
+#else
+  return kernel == TransformKernel::kScalar;
+#endif
+}
+
+TransformKernel DetectTransformKernel() {
+  static const TransformKernel detected = [] {
+    if (KernelSupported(TransformKernel::kAvx2)) {
+      return TransformKernel::kAvx2;
+    }
+    if (KernelSupported(TransformKernel::kSse2)) {
+      return TransformKernel::kSse2;
+    }
+    return TransformKernel::kScalar;
+  }();
+  return detected;
+}
+
+void TransformCoords(const Transform& transform, const double* in,
+                     double* out, std::size_t count) {
+  TransformCoords(transform, in, out, count, DetectTransformKernel());
+}
+
+void TransformCoords(const Transform& transform, const double* in,
+                     double* out, std::size_t count, TransformKernel kernel) {
+  AffineColumns columns = ColumnsOf(transform);
+#ifdef S21_X86_KERNELS
+  if (kernel == TransformKernel::kAvx2 && KernelSupported(kernel)) {
+    Avx2Kernel(columns, in, out, count);
+    return;
+  }
+  if (kernel == TransformKernel::kSse2 && KernelSupported(kernel)) {
+    Sse2Kernel(columns, in, out, count);
+    return;
+  }
+#endif
+  ScalarKernel(columns, in, out, count);
+}
+
+}  // namespace s21
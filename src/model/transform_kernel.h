@@ -0,0 +1,27 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_TRANSFORM_KERNEL_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_TRANSFORM_KERNEL_H
+
+#include <cstddef>
+
+#include "transform.h"
+
+namespace s21 {
+
+enum class TransformKernel { kScalar, kSse2, kAvx2 };
+
+// Лучшее ядро, доступное на этом процессоре.
+TransformKernel DetectTransformKernel();
+bool KernelSupported(TransformKernel kernel);
+
+// Применяет transform к count вершинам xyz. Все ядра выполняют умножения и
+// сложения в том же порядке, что Transform::Apply; kAvx2 сливает их в FMA,
+// поэтому может расходиться с остальными в последнем знаке. in и out могут
+// совпадать.
+void TransformCoords(const Transform& transform, const double* in,
+                     double* out, std::size_t count);
+void TransformCoords(const Transform& transform, const double* in,
+                     double* out, std::size_t count, TransformKernel kernel);
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_TRANSFORM_KERNEL_H
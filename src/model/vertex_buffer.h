@@ -0,0 +1,73 @@
+#ifndef CPP4_S21_3DVIEWER_V2_SRC_MODEL_VERTEX_BUFFER_H
+#define CPP4_S21_3DVIEWER_V2_SRC_MODEL_VERTEX_BUFFER_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "span.h"
+
+namespace s21 {
+
+// Координаты по отдельным массивам для векторных проходов.
+struct VertexComponents {
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+};
+
+// Вершины одним непрерывным массивом x0 y0 z0 x1 y1 z1 ... Вершина v
+// занимает coords[3 * v, 3 * v + 3), индексы граней начинаются с нуля.
+class VertexBuffer {
+ public:
+  std::size_t size() const { return coords.size() / 3; }
+  bool empty() const { return coords.empty(); }
+  const double* operator[](std::size_t vertex) const {
+    return coords.data() + 3 * vertex;
+  }
+  double* operator[](std::size_t vertex) { return coords.data() + 3 * vertex; }
+  const double* data() const { return coords.data(); }
+  double* data() { return coords.data(); }
+
+  Span<const double> Coords() const { return {coords.data(), coords.size()}; }
+  Span<double> MutableCoords() { return {coords.data(), coords.size()}; }
+
+  void Clear() { coords.clear(); }
+  void Reserve(std::size_t vertices) { coords.reserve(3 * vertices); }
+  void Resize(std::size_t vertices) { coords.resize(3 * vertices); }
+  void Assign(std::vector<double> new_coords) { coords = std::move(new_coords); }
+  void Push(double x, double y, double z) {
+    coords.push_back(x);
+    coords.push_back(y);
+    coords.push_back(z);
+  }
+  void Append(const double* first, const double* last) {
+    coords.insert(coords.end(), first, last);
+  }
+
+  // Копия в раскладке SoA: отдельно все x, все y и все z.
+  VertexComponents Components() const {
+    VertexComponents components;
+    components.x.reserve(size());
+    components.y.reserve(size());
+    components.z.reserve(size());
+    for (std::size_t i = 0; i < coords.size(); i += 3) {
+      components.x.push_back(coords[i]);
+      components.y.push_back(coords[i + 1]);
+      components.z.push_back(coords[i + 2]);
+    }
+    return components;
+  }
+
+  bool operator==(const VertexBuffer& other) const {
+    return coords == other.coords;
+  }
+  bool operator!=(const VertexBuffer& other) const { return !(*this == other); }
+
+ private:
+  std::vector<double> coords;
+};
+
+}  // namespace s21
+
+#endif  // CPP4_S21_3DVIEWER_V2_SRC_MODEL_VERTEX_BUFFER_H
@@ -1,9 +1,58 @@
 #include <gtest/gtest.h>
+#include <zlib.h>
 
+#include <filesystem>
+#include <set>
+
+#include "model/command.h"
 #include "model/model.h"
 
 namespace s21 {
 
+namespace {
+
+std::string WriteGridObj(const std::string& file_path, int size,
+                         const std::string& tail = "") {
+  std::ofstream file(file_path);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      file << "v " << i * 0.125 << ' ' << j / 3.0 << ' ' << (i ^ j) * 1e-3
+           << '\n';
+    }
+    if (i > 0) {
+      for (int j = 0; j + 1 < size; j++) {
+        if (j % 5 == 0) {
+          file << "f " << -(size - j) << ' ' << -(size - j - 1) << ' '
+               << -(2 * size - j - 1) << ' ' << -(2 * size - j) << '\n';
+        } else if (j % 17 == 0) {
+          file << "f " << i * size + j << "\nf " << (i - 1) * size + j + 1
+               << ' ' << i * size + j + 1 << '\n';
+        } else {
+          file << "f " << (i - 1) * size + j + 1 << "/1/1 "
+               << (i - 1) * size + j + 2 << "//2 " << i * size + j + 2
+               << '\n';
+        }
+      }
+    }
+  }
+  file << tail;
+  return file_path;
+}
+
+std::vector<int> ToVector(Span<const int> facet) {
+  return std::vector<int>(facet.begin(), facet.end());
+}
+
+std::vector<std::vector<double>> Rows(const VertexBuffer& vertices) {
+  std::vector<std::vector<double>> rows;
+  for (std::size_t i = 0; i < vertices.size(); i++) {
+    rows.emplace_back(vertices[i], vertices[i] + 3);
+  }
+  return rows;
+}
+
+}  // namespace
+
 class ModelTest : public ::testing::Test {
  protected:
   Model* model;
@@ -42,11 +91,10 @@ TEST_F(ModelTest, ParseModelDataTest) {
 
   model->ParseModelData(file_path);
 
-  const auto& vertices = model->GetMatrix3D();
-  const auto& facets = model->GetPolygons();
+  const auto vertices = Rows(model->GetVertices());
+  const auto& facets = model->GetFacets();
 
   std::vector<std::vector<double>> expected_vertices = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, -1.000000},
       {1.000000, -1.000000, -1.000000},
       {1.000000, 1.000000, 1.000000},
@@ -57,36 +105,59 @@ TEST_F(ModelTest, ParseModelDataTest) {
       {-1.000000, -1.000000, 1.000000}};
 
   ASSERT_EQ(vertices.size(), expected_vertices.size());
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     EXPECT_EQ(vertices[i], expected_vertices[i]);
   }
 
-  std::vector<Facet> expected_facets = {{},
-                                        {{5, 3, 1}, 3},
-                                        {{3, 8, 4}, 3},
-                                        {{7, 6, 8}, 3},
-                                        {{2, 8, 6}, 3},
-                                        {{1, 4, 2}, 3},
-                                        {{5, 2, 6}, 3},
-                                        {{5, 7, 3}, 3},
-                                        {{3, 7, 8}, 3},
-                                        {{7, 5, 6}, 3},
-                                        {{2, 4, 8}, 3},
-                                        {{1, 3, 4}, 3},
-                                        {{5, 1, 2}, 3}};
+  std::vector<std::vector<int>> expected_facets = {
+      {4, 2, 0}, {2, 7, 3}, {6, 5, 7}, {1, 7, 5}, {0, 3, 1}, {4, 1, 5},
+      {4, 6, 2}, {2, 6, 7}, {6, 4, 5}, {1, 3, 7}, {0, 2, 3}, {4, 0, 1}};
 
   ASSERT_EQ(facets.size(), expected_facets.size());
-  for (size_t i = 1; i < facets.size(); ++i) {
-    EXPECT_EQ(facets[i].vertices, expected_facets[i].vertices);
-    EXPECT_EQ(facets[i].count_vertices_in_facets,
-              expected_facets[i].count_vertices_in_facets);
+  for (size_t i = 0; i < facets.size(); ++i) {
+    EXPECT_EQ(ToVector(facets[i]), expected_facets[i]);
   }
+  EXPECT_EQ(facets.Offsets().back(), 36);
 
   model->ClearData();
   EXPECT_EQ(model->GetVertexCount(), 0);
   EXPECT_EQ(model->GetFacetCount(), 0);
 }
 
+TEST_F(ModelTest, VertexBufferAccessors) {
+  model->ParseModelData("obj/pyramid.obj");
+  const VertexBuffer& vertices = model->GetVertices();
+  ASSERT_EQ(vertices.size(), 5U);
+  EXPECT_EQ(vertices.Coords().size(), 15U);
+  EXPECT_EQ(vertices.data() + 3, vertices[1]);
+
+  VertexComponents components = vertices.Components();
+  ASSERT_EQ(components.x.size(), 5U);
+  for (std::size_t i = 0; i < vertices.size(); i++) {
+    EXPECT_EQ(components.x[i], vertices[i][0]);
+    EXPECT_EQ(components.y[i], vertices[i][1]);
+    EXPECT_EQ(components.z[i], vertices[i][2]);
+  }
+
+  std::vector<double> coords(15, 1.5);
+  model->SetVertices(coords);
+  EXPECT_EQ(model->GetVertices()[4][2], 1.5);
+  EXPECT_THROW(model->SetVertices(std::vector<double>(12, 0.0)),
+               std::runtime_error);
+}
+
+TEST_F(ModelTest, ParseModelDataSinglePass) {
+  model->ParseModelData("obj/cube.obj");
+  EXPECT_EQ(model->GetVertexCount(), 8);
+  EXPECT_EQ(model->GetFacetCount(), 12);
+  EXPECT_EQ(model->GetVertices().size(), 8U);
+  EXPECT_EQ(model->GetFacets().size(), 12U);
+
+  model->ParseModelData("obj/pyramid.obj");
+  EXPECT_EQ(model->GetVertexCount(), 5);
+  EXPECT_EQ(model->GetFacetCount(), 4);
+}
+
 TEST_F(ModelTest, ParseModelDataTest2) {
   std::string file_path = "obj/skull.obj";
 
@@ -106,6 +177,343 @@ TEST_F(ModelTest, ParseModelDataTest2) {
   EXPECT_EQ(model->GetFacetCount(), 0);
 }
 
+TEST_F(ModelTest, ParseModelDataMappedMatchesStream) {
+  for (const char* file_path : {"obj/cube.obj", "obj/pyramid.obj"}) {
+    Model stream_model;
+    stream_model.SetLoadMode(LoadMode::kStream);
+    stream_model.ParseModelData(file_path);
+
+    model->SetLoadMode(LoadMode::kMapped);
+    model->ParseModelData(file_path);
+
+    EXPECT_EQ(model->GetVertexCount(), stream_model.GetVertexCount());
+    EXPECT_EQ(model->GetFacetCount(), stream_model.GetFacetCount());
+    EXPECT_TRUE(model->GetVertices() == stream_model.GetVertices());
+    EXPECT_TRUE(model->GetFacets() == stream_model.GetFacets());
+    EXPECT_GT(model->GetLoadStats().bytes, 0U);
+    EXPECT_EQ(model->GetLoadStats().bytes, stream_model.GetLoadStats().bytes);
+  }
+}
+
+TEST_F(ModelTest, ParseModelDataStreamIncorrect) {
+  model->SetLoadMode(LoadMode::kStream);
+  EXPECT_THROW(model->ParseModelData("obj/skulll.obj"), std::exception);
+  EXPECT_THROW(model->ParseModelData("obj/invalid_vertex_index.obj"),
+               std::runtime_error);
+  EXPECT_THROW(model->ParseModelData("obj/less_than_3_coordinates.obj"),
+               std::runtime_error);
+}
+
+TEST_F(ModelTest, ParseModelDataParallelMatchesSerial) {
+  std::string file_path = WriteGridObj("parallel_grid.obj", 220);
+  Model serial_model;
+  serial_model.SetLoadMode(LoadMode::kMapped);
+  serial_model.ParseModelData(file_path);
+  ASSERT_GT(serial_model.GetLoadStats().bytes, 1U << 20);
+
+  model->SetLoadMode(LoadMode::kParallel);
+  for (unsigned threads : {2U, 3U, 8U}) {
+    model->SetLoadThreads(threads);
+    model->ParseModelData(file_path);
+    EXPECT_EQ(model->GetVertexCount(), serial_model.GetVertexCount());
+    EXPECT_EQ(model->GetFacetCount(), serial_model.GetFacetCount());
+    EXPECT_TRUE(model->GetVertices() == serial_model.GetVertices());
+    EXPECT_TRUE(model->GetFacets() == serial_model.GetFacets());
+  }
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, ParseModelDataParallelIncorrect) {
+  std::string file_path =
+      WriteGridObj("parallel_invalid.obj", 220, "f 1 2 48402\n");
+  model->SetLoadMode(LoadMode::kParallel);
+  model->SetLoadThreads(4);
+  EXPECT_THROW(model->ParseModelData(file_path), std::runtime_error);
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, ParseModelDataProgressAndCancel) {
+  std::string file_path = WriteGridObj("progress_grid.obj", 220);
+  for (LoadMode mode :
+       {LoadMode::kStream, LoadMode::kMapped, LoadMode::kParallel}) {
+    std::size_t last_done = 0;
+    std::size_t last_total = 0;
+    LoadControl control;
+    control.progress = [&](std::size_t done, std::size_t total) {
+      last_done = done;
+      last_total = total;
+    };
+    model->SetLoadMode(mode);
+    model->SetLoadThreads(2);
+    model->SetLoadControl(control);
+    model->ParseModelData(file_path);
+    EXPECT_EQ(last_done, model->GetLoadStats().bytes);
+    EXPECT_EQ(last_total, model->GetLoadStats().bytes);
+
+    std::atomic<bool> cancel(true);
+    control.cancel = &cancel;
+    model->SetLoadControl(control);
+    EXPECT_THROW(model->ParseModelData(file_path), LoadCancelled);
+  }
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, ParseModelDataPublishesBatches) {
+  std::string file_path = WriteGridObj("batch_grid.obj", 220);
+  for (LoadMode mode : {LoadMode::kMapped, LoadMode::kParallel}) {
+    std::vector<double> coords;
+    std::size_t facets = 0;
+    LoadControl control;
+    control.batch_interval = std::chrono::milliseconds(0);
+    control.batch = [&](LoadBatch&& batch) {
+      EXPECT_EQ(static_cast<std::size_t>(batch.first_vertex),
+                coords.size() / 3);
+      coords.insert(coords.end(), batch.coords.begin(), batch.coords.end());
+      facets += batch.facet_sizes.size();
+      for (int index : batch.indices) {
+        EXPECT_GE(index, 0);
+        EXPECT_LT(static_cast<std::size_t>(index), coords.size() / 3);
+      }
+    };
+    model->SetLoadMode(mode);
+    model->SetLoadThreads(3);
+    model->SetLoadControl(control);
+    model->ParseModelData(file_path);
+
+    const auto& vertices = model->GetVertices();
+    ASSERT_EQ(coords.size(), 3 * vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      EXPECT_EQ(coords[3 * i], vertices[i][0]);
+      EXPECT_EQ(coords[3 * i + 2], vertices[i][2]);
+    }
+    EXPECT_GT(facets, 0U);
+    EXPECT_LE(facets, model->GetFacets().size());
+  }
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, LoadModelDataUsesCache) {
+  std::string file_path = WriteGridObj("cache_grid.obj", 60);
+  std::string cache_path = MeshCache().CachePath(file_path);
+  std::remove(cache_path.c_str());
+  Model parsed_model;
+  parsed_model.ParseModelData(file_path);
+
+  model->SetCacheEnabled(true);
+  model->LoadModelData(file_path);
+  EXPECT_FALSE(model->GetLoadStats().from_cache);
+  model->LoadModelData(file_path);
+  EXPECT_TRUE(model->GetLoadStats().from_cache);
+  EXPECT_EQ(model->GetVertexCount(), parsed_model.GetVertexCount());
+  EXPECT_EQ(model->GetFacetCount(), parsed_model.GetFacetCount());
+  EXPECT_TRUE(model->GetVertices() == parsed_model.GetVertices());
+  EXPECT_TRUE(model->GetFacets() == parsed_model.GetFacets());
+
+  {
+    std::fstream cache(cache_path,
+                       std::ios::in | std::ios::out | std::ios::binary);
+    cache.seekp(-5, std::ios::end);
+    cache.put('\x7f');
+  }
+  model->LoadModelData(file_path);
+  EXPECT_FALSE(model->GetLoadStats().from_cache);
+  EXPECT_TRUE(model->GetVertices() == parsed_model.GetVertices());
+  model->LoadModelData(file_path);
+  EXPECT_TRUE(model->GetLoadStats().from_cache);
+  EXPECT_FALSE(std::ifstream(file_path + ".s21cache").is_open());
+
+  // Та же длина и то же время изменения, но другое содержимое
+  auto mtime = std::filesystem::last_write_time(file_path);
+  {
+    std::fstream obj(file_path, std::ios::in | std::ios::out);
+    obj.seekp(2);
+    obj.put('7');
+  }
+  std::filesystem::last_write_time(file_path, mtime);
+  model->LoadModelData(file_path);
+  EXPECT_FALSE(model->GetLoadStats().from_cache);
+  EXPECT_FALSE(model->GetVertices() == parsed_model.GetVertices());
+  parsed_model.ParseModelData(file_path);
+  model->LoadModelData(file_path);
+  EXPECT_TRUE(model->GetLoadStats().from_cache);
+
+  std::ofstream(file_path, std::ios::app) << "v 9 9 9\n";
+  model->LoadModelData(file_path);
+  EXPECT_FALSE(model->GetLoadStats().from_cache);
+  EXPECT_EQ(model->GetVertexCount(), parsed_model.GetVertexCount() + 1);
+
+  std::remove(cache_path.c_str());
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, LoadModelDataRejectsCachedIndicesOutOfRange) {
+  std::string file_path = WriteGridObj("cache_range_grid.obj", 4);
+  MeshCache cache;
+  std::string cache_path = cache.CachePath(file_path);
+  std::remove(cache_path.c_str());
+  Model parsed_model;
+  parsed_model.ParseModelData(file_path);
+
+  // Целостный по хешу кэш, в котором один индекс указывает за вершины
+  const VertexBuffer& vertices = parsed_model.GetVertices();
+  std::vector<int> indices = parsed_model.GetFacets().Indices();
+  indices[1] = static_cast<int>(vertices.size());
+  MeshArrays mesh;
+  mesh.vertices = vertices.data();
+  mesh.vertex_count = vertices.size();
+  mesh.offsets = parsed_model.GetFacets().Offsets().data();
+  mesh.polygon_count = parsed_model.GetFacets().size();
+  mesh.indices = indices.data();
+  mesh.index_count = indices.size();
+  mesh.facet_count = parsed_model.GetFacetCount();
+  CacheKey key = MeshCache::KeyFor(file_path);
+  ASSERT_TRUE(cache.Store(file_path, key, mesh));
+  MeshArrays opened;
+  EXPECT_EQ(cache.Open(file_path, key, opened), nullptr);
+
+  model->SetCacheEnabled(true);
+  model->LoadModelData(file_path);
+  EXPECT_FALSE(model->GetLoadStats().from_cache);
+  EXPECT_TRUE(model->GetFacets() == parsed_model.GetFacets());
+  model->LoadModelData(file_path);
+  EXPECT_TRUE(model->GetLoadStats().from_cache);
+
+  std::remove(cache_path.c_str());
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, ParseModelDataFacetAttributes) {
+  std::string file_path = "obj/attributes_test.obj";
+  {
+    std::ofstream file(file_path);
+    file << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\n"
+         << "vt 0 0\nvt 1 0\nvt 0.5 1 0\nvn 0 0 1\nvn 1 0 0\n"
+         << "f 1/1/1 2/2/1 3/3/1\nf 1//2 -2//-1 4//2\nf 2/-1 3/1 4/2\nf 1 2 4\n";
+  }
+  for (auto mode : {LoadMode::kStream, LoadMode::kMapped}) {
+    model->SetLoadMode(mode);
+    model->ParseModelData(file_path);
+    EXPECT_EQ(model->GetVertexCount(), 4);
+    EXPECT_EQ(model->GetFacetCount(), 4);
+    EXPECT_EQ(ToVector(model->GetFacets()[1]), (std::vector<int>{0, 2, 3}));
+    EXPECT_FALSE(model->AttributesLoaded());
+
+    const AttributeStreams& streams = model->GetAttributes();
+    EXPECT_TRUE(model->AttributesLoaded());
+    EXPECT_EQ(streams.tex_coords,
+              (std::vector<double>{0.0, 0.0, 1.0, 0.0, 0.5, 1.0}));
+    EXPECT_EQ(streams.normals,
+              (std::vector<double>{0.0, 0.0, 1.0, 1.0, 0.0, 0.0}));
+    EXPECT_EQ(streams.tex_indices,
+              (std::vector<int>{1, 2, 3, 0, 0, 0, 3, 1, 2, 0, 0, 0}));
+    EXPECT_EQ(streams.normal_indices,
+              (std::vector<int>{1, 1, 1, 2, 2, 2, 0, 0, 0, 0, 0, 0}));
+  }
+
+  for (const char* token : {"1/", "1/2/", "1//", "1/a", "1x", "/1"}) {
+    {
+      std::ofstream file(file_path);
+      file << "v 0 0 0\nv 1 0 0\nf 1 2 " << token << "\n";
+    }
+    EXPECT_THROW(model->ParseModelData(file_path), std::runtime_error)
+        << token;
+  }
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, ParseModelDataCompressed) {
+  std::string file_path = WriteGridObj("obj/compressed_test.obj", 300);
+  std::string gz_path = file_path + ".gz";
+  {
+    std::ifstream source(file_path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(source)),
+                     std::istreambuf_iterator<char>());
+    // Два члена gzip подряд, как после cat a.gz b.gz.
+    gzFile gz = gzopen(gz_path.c_str(), "wb");
+    gzwrite(gz, text.data(), static_cast<unsigned>(text.size() / 2));
+    gzclose(gz);
+    gz = gzopen(gz_path.c_str(), "ab");
+    gzwrite(gz, text.data() + text.size() / 2,
+            static_cast<unsigned>(text.size() - text.size() / 2));
+    gzclose(gz);
+  }
+  EXPECT_FALSE(CompressedFile::IsCompressed(file_path));
+  EXPECT_TRUE(CompressedFile::IsCompressed(gz_path));
+
+  Model expected;
+  expected.SetLoadMode(LoadMode::kMapped);
+  expected.ParseModelData(file_path);
+  std::size_t last_done = 0;
+  std::size_t last_total = 0;
+  LoadControl control;
+  control.progress = [&](std::size_t done, std::size_t total) {
+    last_done = done;
+    last_total = total;
+  };
+  model->SetLoadControl(control);
+  model->ParseModelData(gz_path);
+  EXPECT_EQ(model->GetVertexCount(), expected.GetVertexCount());
+  EXPECT_EQ(model->GetFacetCount(), expected.GetFacetCount());
+  EXPECT_TRUE(model->GetVertices() == expected.GetVertices());
+  EXPECT_TRUE(model->GetFacets() == expected.GetFacets());
+  EXPECT_GT(model->GetLoadStats().bytes, last_total);
+  EXPECT_EQ(last_done, last_total);
+
+  std::string truncated_path = "obj/truncated_test.obj.gz";
+  {
+    std::ifstream source(gz_path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(source)),
+                     std::istreambuf_iterator<char>());
+    std::ofstream(truncated_path, std::ios::binary)
+        .write(data.data(), data.size() / 4);
+  }
+  EXPECT_THROW(model->ParseModelData(truncated_path), std::runtime_error);
+  std::remove(truncated_path.c_str());
+  std::remove(gz_path.c_str());
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, CleanupMeshWeldsAndDropsFacets) {
+  std::string file_path = "obj/cleanup_test.obj";
+  {
+    std::ofstream file(file_path);
+    file << "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+         << "v 1 0 0\nv 1 1 0\nv 0 1 0.0000001\n"
+         << "vt 0 0\nvt 1 1\n"
+         << "f 1/1 2/1 3/1\nf 4/2 5/2 6/2\n"
+         << "f 3 2 1\nf 1 1 2\nf 1 2 4\nf 1 2 5 3\n"
+         << "v 2 0 0\nf 1 2 7\nf 1 2\nf 2 1\nf 3 3\n";
+  }
+  model->SetLoadMode(LoadMode::kMapped);
+  model->SetCleanupEnabled(true);
+  model->LoadModelData(file_path);
+  // Точное совпадение склеивает только вершину 4 с вершиной 2.
+  EXPECT_EQ(model->GetVertexCount(), 6);
+  EXPECT_EQ(model->GetCleanupStats().removed_vertices, 1);
+  // Удалены: повтор 3 2 1, две вырожденные, коллинеарная, повтор отрезка и
+  // отрезок из одной вершины.
+  EXPECT_EQ(model->GetCleanupStats().removed_facets, 6);
+  ASSERT_EQ(model->GetFacets().size(), 4U);
+  EXPECT_EQ(ToVector(model->GetFacets()[1]), (std::vector<int>{1, 3, 4}));
+  EXPECT_EQ(ToVector(model->GetFacets()[2]), (std::vector<int>{0, 1, 3, 2}));
+  EXPECT_EQ(ToVector(model->GetFacets()[3]), (std::vector<int>{0, 1}));
+  EXPECT_EQ(model->GetFacetCount(), 5);
+  EXPECT_EQ(model->GetAttributes().tex_indices,
+            (std::vector<int>{1, 1, 1, 2, 2, 2, 0, 0, 0, 0, 0, 0}));
+
+  model->SetWeldEpsilon(1e-6);
+  model->LoadModelData(file_path);
+  EXPECT_EQ(model->GetVertexCount(), 5);
+  EXPECT_EQ(model->GetCleanupStats().removed_vertices, 2);
+  EXPECT_EQ(ToVector(model->GetFacets()[1]), (std::vector<int>{1, 3, 2}));
+
+  model->SetCleanupEnabled(false);
+  model->LoadModelData(file_path);
+  EXPECT_EQ(model->GetVertexCount(), 7);
+  EXPECT_EQ(model->GetCleanupStats().removed_facets, 0);
+  std::remove(file_path.c_str());
+}
+
 TEST_F(ModelTest, ParseModelDataIncorrect) {
   EXPECT_THROW(model->ParseModelData("obj/skulll.obj"), std::exception);
 }
@@ -145,7 +553,6 @@ TEST_F(ModelTest, RotateModelTestX) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_x = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, 1.000000},
       {1.000000, 1.000000, -1.000000},
       {1.000000, -1.000000, 1.000000},
@@ -158,11 +565,11 @@ TEST_F(ModelTest, RotateModelTestX) {
   model->RotateModel(M_PI / 2, 'x');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_x.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_x[i][j], tolerance);
     }
@@ -180,7 +587,6 @@ TEST_F(ModelTest, RotateModelTestY) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_y = {
-      {0.0, 0.0, 0.0},
       {-1.000000, 1.000000, -1.000000},
       {-1.000000, -1.000000, -1.000000},
       {1.000000, 1.000000, -1.000000},
@@ -193,11 +599,11 @@ TEST_F(ModelTest, RotateModelTestY) {
   model->RotateModel(M_PI / 2, 'y');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_y.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_y[i][j], tolerance);
     }
@@ -215,7 +621,6 @@ TEST_F(ModelTest, RotateModelTestZ) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_z = {
-      {0.0, 0.0, 0.0},
       {-1.000000, 1.000000, -1.000000},
       {1.000000, 1.000000, -1.000000},
       {-1.000000, 1.000000, 1.000000},
@@ -228,11 +633,11 @@ TEST_F(ModelTest, RotateModelTestZ) {
   model->RotateModel(M_PI / 2, 'z');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_z.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_z[i][j], tolerance);
     }
@@ -250,7 +655,6 @@ TEST_F(ModelTest, RotateModelTestXX) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_x = {
-      {0.0, 0.0, 0.0},
       {1.000000, -1.000000, -1.000000},
       {1.000000, -1.000000, 1.000000},
       {1.000000, 1.000000, -1.000000},
@@ -263,11 +667,11 @@ TEST_F(ModelTest, RotateModelTestXX) {
   model->RotateModel(M_PI / 2, 'X');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_x.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_x[i][j], tolerance);
     }
@@ -285,7 +689,6 @@ TEST_F(ModelTest, RotateModelTestYY) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_y = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, 1.000000},
       {1.000000, -1.000000, 1.000000},
       {-1.000000, 1.000000, 1.000000},
@@ -298,11 +701,11 @@ TEST_F(ModelTest, RotateModelTestYY) {
   model->RotateModel(M_PI / 2, 'Y');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_y.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_y[i][j], tolerance);
     }
@@ -320,7 +723,6 @@ TEST_F(ModelTest, RotateModelTestZZ) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_z = {
-      {0.0, 0.0, 0.0},
       {1.000000, -1.000000, -1.000000},
       {-1.000000, -1.000000, -1.000000},
       {1.000000, -1.000000, 1.000000},
@@ -333,11 +735,11 @@ TEST_F(ModelTest, RotateModelTestZZ) {
   model->RotateModel(M_PI / 2, 'Z');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_z.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_z[i][j], tolerance);
     }
@@ -355,7 +757,6 @@ TEST_F(ModelTest, RotateModelTestIncorrect) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_z = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, -1.000000},
       {1.000000, -1.000000, -1.000000},
       {1.000000, 1.000000, 1.000000},
@@ -368,11 +769,11 @@ TEST_F(ModelTest, RotateModelTestIncorrect) {
   model->RotateModel(M_PI / 2, 't');
   model->ApplyRotation();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_z.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_z[i][j], tolerance);
     }
@@ -390,7 +791,6 @@ TEST_F(ModelTest, MoveModelTestX) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_x = {
-      {0.0, 0.0, 0.0},
       {3.000000, 1.000000, -1.000000},
       {3.000000, -1.000000, -1.000000},
       {3.000000, 1.000000, 1.000000},
@@ -402,11 +802,11 @@ TEST_F(ModelTest, MoveModelTestX) {
 
   model->MoveModel(2.0, 'x');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_x.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_x[i][j], tolerance);
     }
@@ -424,7 +824,6 @@ TEST_F(ModelTest, MoveModelTestY) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_y = {
-      {0.0, 0.0, 0.0},
       {1.000000, 3.000000, -1.000000},
       {1.000000, 1.000000, -1.000000},
       {1.000000, 3.000000, 1.000000},
@@ -436,11 +835,11 @@ TEST_F(ModelTest, MoveModelTestY) {
 
   model->MoveModel(2.0, 'y');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_y.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_y[i][j], tolerance);
     }
@@ -458,7 +857,6 @@ TEST_F(ModelTest, MoveModelTestZ) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_z = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, 1.000000},
       {1.000000, -1.000000, 1.000000},
       {1.000000, 1.000000, 3.000000},
@@ -470,11 +868,11 @@ TEST_F(ModelTest, MoveModelTestZ) {
 
   model->MoveModel(2.0, 'z');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_z.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_z[i][j], tolerance);
     }
@@ -492,7 +890,6 @@ TEST_F(ModelTest, MoveModelTestXX) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_x = {
-      {0.0, 0.0, 0.0},
       {-1.000000, 1.000000, -1.000000},
       {-1.000000, -1.000000, -1.000000},
       {-1.000000, 1.000000, 1.000000},
@@ -504,11 +901,11 @@ TEST_F(ModelTest, MoveModelTestXX) {
 
   model->MoveModel(2.0, 'X');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_x.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_x[i][j], tolerance);
     }
@@ -526,7 +923,6 @@ TEST_F(ModelTest, MoveModelTestYY) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_y = {
-      {0.0, 0.0, 0.0},
       {1.000000, -1.000000, -1.000000},
       {1.000000, -3.000000, -1.000000},
       {1.000000, -1.000000, 1.000000},
@@ -538,11 +934,11 @@ TEST_F(ModelTest, MoveModelTestYY) {
 
   model->MoveModel(2.0, 'Y');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_y.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_y[i][j], tolerance);
     }
@@ -560,7 +956,6 @@ TEST_F(ModelTest, MoveModelTestZZ) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_z = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, -3.000000},
       {1.000000, -1.000000, -3.000000},
       {1.000000, 1.000000, -1.000000},
@@ -572,11 +967,11 @@ TEST_F(ModelTest, MoveModelTestZZ) {
 
   model->MoveModel(2.0, 'Z');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_z.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_z[i][j], tolerance);
     }
@@ -594,7 +989,6 @@ TEST_F(ModelTest, MoveModelTestIncorrect) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_vertices_z = {
-      {0.0, 0.0, 0.0},
       {1.000000, 1.000000, -1.000000},
       {1.000000, -1.000000, -1.000000},
       {1.000000, 1.000000, 1.000000},
@@ -606,11 +1000,11 @@ TEST_F(ModelTest, MoveModelTestIncorrect) {
 
   model->MoveModel(2.0, 't');
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_vertices_z.size());
 
   double tolerance = 1e-5;
-  for (size_t i = 1; i < vertices.size(); ++i) {
+  for (size_t i = 0; i < vertices.size(); ++i) {
     for (size_t j = 0; j < 3; ++j) {
       EXPECT_NEAR(vertices[i][j], expected_vertices_z[i][j], tolerance);
     }
@@ -628,13 +1022,13 @@ TEST_F(ModelTest, CenterModelTest) {
   model->ParseModelData(file_path);
 
   std::vector<std::vector<double>> expected_centered_vertices = {
-      {0, 0, 0},          {2.12, 4.12, 2.4},   {-2.12, -4.12, -5.6},
-      {2.12, -4.12, 2.4}, {-2.12, 4.12, -5.6}, {0, 0, 6.4},
+      {2.12, 4.12, 2.4},   {-2.12, -4.12, -5.6}, {2.12, -4.12, 2.4},
+      {-2.12, 4.12, -5.6}, {0, 0, 6.4},
   };
 
   model->CenterModel();
 
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_centered_vertices.size());
 
   double tolerance = 1e-5;
@@ -658,8 +1052,8 @@ TEST_F(ModelTest, ScaleModelToFitTest) {
   double scale_factor = 10.0;
 
   std::vector<std::vector<double>> expected_scaled_vertices = {
-      {0, 0, 0},        {2.65, 5.15, 5},   {-2.65, -5.15, -5},
-      {2.65, -5.15, 5}, {-2.65, 5.15, -5}, {0, 0, 10}};
+      {2.65, 5.15, 5},   {-2.65, -5.15, -5}, {2.65, -5.15, 5},
+      {-2.65, 5.15, -5}, {0, 0, 10}};
 
   double max_distance = 0.0;
   for (const auto& vertex : expected_scaled_vertices) {
@@ -679,7 +1073,7 @@ TEST_F(ModelTest, ScaleModelToFitTest) {
   }
 
   model->ScaleModelToFit(scale_factor);
-  const auto& vertices = model->GetMatrix3D();
+  const auto vertices = Rows(model->GetVertices());
   ASSERT_EQ(vertices.size(), expected_scaled_vertices.size());
 
   double tolerance = 1e-5;
@@ -693,6 +1087,554 @@ TEST_F(ModelTest, ScaleModelToFitTest) {
   EXPECT_EQ(model->GetFacetCount(), 0);
 }
 
+TEST_F(ModelTest, DeferredTransformKeepsSourceVertices) {
+  model->ParseModelData("obj/pyramid.obj");
+  const auto source = Rows(model->GetSourceVertices());
+
+  model->RotateModel(M_PI / 2, 'z');
+  model->ApplyRotation();
+  model->MoveModel(1.5, 'x');
+  model->MoveModel(0.5, 'Y');
+  EXPECT_EQ(Rows(model->GetSourceVertices()), source);
+  EXPECT_FALSE(model->GetTransform().IsIdentity());
+
+  // Поворот на 90 градусов вокруг z, затем перенос на (1.5, -0.5, 0).
+  const auto vertices = Rows(model->GetVertices());
+  ASSERT_EQ(vertices.size(), source.size());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    EXPECT_NEAR(vertices[i][0], -source[i][1] + 1.5, 1e-9);
+    EXPECT_NEAR(vertices[i][1], source[i][0] - 0.5, 1e-9);
+    EXPECT_NEAR(vertices[i][2], source[i][2], 1e-9);
+  }
+
+  model->CenterModel();
+  model->ScaleModelToFit(2.0);
+  Transform saved = model->GetTransform();
+  const auto fitted = Rows(model->GetVertices());
+  model->SetTransform(Transform());
+  EXPECT_EQ(Rows(model->GetVertices()), source);
+  model->SetTransform(saved);
+  EXPECT_EQ(Rows(model->GetVertices()), fitted);
+
+  model->ParseModelData("obj/pyramid.obj");
+  EXPECT_TRUE(model->GetTransform().IsIdentity());
+}
+
+TEST_F(ModelTest, TransformComposition) {
+  Transform move = Transform::Translation(1.0, 2.0, 3.0);
+  Transform scale = Transform::Scaling(2.0);
+  double point[3] = {1.0, -1.0, 0.5};
+  double result[3];
+  (scale * move).Apply(point, result);
+  EXPECT_DOUBLE_EQ(result[0], 4.0);
+  EXPECT_DOUBLE_EQ(result[1], 2.0);
+  EXPECT_DOUBLE_EQ(result[2], 7.0);
+  (move * scale).Apply(point, result);
+  EXPECT_DOUBLE_EQ(result[0], 3.0);
+  EXPECT_DOUBLE_EQ(result[1], 0.0);
+  EXPECT_DOUBLE_EQ(result[2], 4.0);
+  EXPECT_EQ(move.Data()[12], 1.0);
+  EXPECT_TRUE(Transform::Rotation('t', 1.0).IsIdentity());
+}
+
+TEST_F(ModelTest, TransformKernelsMatchRotateExpectations) {
+  model->ParseModelData("obj/cube.obj");
+  const VertexBuffer& source = model->GetSourceVertices();
+  // Поворот на 90 градусов, как в RotateModelTest*: координата k образа
+  // равна sign[k] * p[from[k]].
+  struct Case {
+    char axis;
+    int from[3];
+    double sign[3];
+  };
+  const Case cases[] = {
+      {'x', {0, 2, 1}, {1, -1, 1}}, {'y', {2, 1, 0}, {1, 1, -1}},
+      {'z', {1, 0, 2}, {-1, 1, 1}}, {'X', {0, 2, 1}, {1, 1, -1}},
+      {'Y', {2, 1, 0}, {-1, 1, 1}}, {'Z', {1, 0, 2}, {1, -1, 1}},
+  };
+  for (const Case& rotation : cases) {
+    model->SetTransform(Transform());
+    model->RotateModel(M_PI / 2, rotation.axis);
+    model->ApplyRotation();
+    const VertexBuffer& rotated = model->GetVertices();
+    for (TransformKernel kernel :
+         {TransformKernel::kScalar, TransformKernel::kSse2,
+          TransformKernel::kAvx2}) {
+      if (!KernelSupported(kernel)) {
+        continue;
+      }
+      std::vector<double> coords(source.data(),
+                                 source.data() + source.Coords().size());
+      TransformCoords(model->GetTransform(), coords.data(), coords.data(),
+                      source.size(), kernel);
+      for (std::size_t i = 0; i < source.size(); i++) {
+        for (int k = 0; k < 3; k++) {
+          double expected = rotation.sign[k] * source[i][rotation.from[k]];
+          EXPECT_NEAR(coords[3 * i + k], expected, 1e-5);
+          EXPECT_DOUBLE_EQ(coords[3 * i + k], rotated[i][k]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(ModelTest, TransformAvx2KernelMatchesScalarWithTail) {
+  if (!KernelSupported(TransformKernel::kAvx2)) {
+    GTEST_SKIP();
+  }
+  // Число вершин не кратно четырем, чтобы задеть хвост
+  const std::size_t count = 8191;
+  std::vector<double> coords(3 * count);
+  for (std::size_t i = 0; i < coords.size(); i++) {
+    coords[i] = std::sin(i * 0.37) * 10.0;
+  }
+  Transform transform = Transform::Rotation('x', 0.3) *
+                        Transform::Rotation('y', -1.1) *
+                        Transform::Translation(1.5, -2.0, 0.25);
+  std::vector<double> expected(coords.size());
+  TransformCoords(transform, coords.data(), expected.data(), count,
+                  TransformKernel::kScalar);
+  std::vector<double> result = coords;
+  TransformCoords(transform, result.data(), result.data(), count,
+                  TransformKernel::kAvx2);
+  for (std::size_t i = 0; i < coords.size(); i++) {
+    EXPECT_NEAR(result[i], expected[i], 1e-12);
+  }
+
+}
+
+TEST_F(ModelTest, ParallelForVisitsEveryIndexOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> visits(10007);
+  ParallelFor(&pool, visits.size(), 64, [&](std::size_t begin,
+                                             std::size_t end) {
+    // Неравномерная работа, чтобы потоки забирали чужие куски.
+    if (begin % 3 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    for (std::size_t i = begin; i < end; i++) {
+      visits[i]++;
+    }
+  });
+  for (const auto& count : visits) {
+    EXPECT_EQ(count.load(), 1);
+  }
+  EXPECT_THROW(ParallelFor(&pool, 1000, 10,
+                           [](std::size_t begin, std::size_t) {
+                             if (begin == 500) {
+                               throw std::runtime_error("chunk failed");
+                             }
+                           }),
+               std::runtime_error);
+
+  std::vector<double> values(100000);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    values[i] = 1.0 / (i + 1);
+  }
+  auto sum = [&](ThreadPool* threads) {
+    return ParallelReduce(
+        threads, values.size(), 1000, 0.0,
+        [&](std::size_t begin, std::size_t end) {
+          double local = 0.0;
+          for (std::size_t i = begin; i < end; i++) {
+            local += values[i];
+          }
+          return local;
+        },
+        [](double a, double b) { return a + b; });
+  };
+  double serial = sum(nullptr);
+  ThreadPool small_pool(2);
+  EXPECT_EQ(sum(&pool), serial);
+  EXPECT_EQ(sum(&small_pool), serial);
+}
+
+TEST_F(ModelTest, ParallelTransformsMatchSerial) {
+  std::string file_path = WriteGridObj("transform_grid.obj", 300);
+  Model serial_model;
+  serial_model.SetLoadThreads(1);
+  serial_model.ParseModelData(file_path);
+  model->SetLoadThreads(4);
+  model->ParseModelData(file_path);
+  for (Model* current : {&serial_model, model}) {
+    current->RotateModel(0.3, 'y');
+    current->ApplyRotation();
+    current->CenterModel();
+    current->ScaleModelToFit(3.0);
+  }
+  EXPECT_TRUE(model->GetTransform() == serial_model.GetTransform());
+  EXPECT_TRUE(model->GetVertices() == serial_model.GetVertices());
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, NormalizeModelUsesCachedBounds) {
+  model->ParseModelData("obj/pyramid.obj");
+  Model reference;
+  reference.ParseModelData("obj/pyramid.obj");
+  reference.CenterModel();
+  reference.RotateModel(0.7, 'z');
+  reference.ApplyRotation();
+
+  model->NormalizeModel(2.0);
+  model->RotateModel(0.7, 'z');
+  model->ApplyRotation();
+  model->ScaleModelToFit(5.0);
+  // Радиус после центрирования и поворота берется из кэша.
+  const auto vertices = Rows(model->GetVertices());
+  double max_distance = 0.0;
+  for (const auto& vertex : vertices) {
+    max_distance = std::max(max_distance, sqrt(vertex[0] * vertex[0] +
+                                                vertex[1] * vertex[1] +
+                                                vertex[2] * vertex[2]));
+  }
+  EXPECT_NEAR(max_distance, 5.0, 1e-9);
+  reference.ScaleModelToFit(5.0);
+  const auto expected = Rows(reference.GetVertices());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      EXPECT_NEAR(vertices[i][j], expected[i][j], 1e-9);
+    }
+  }
+
+  BoundingBox box = model->GetBoundingBox();
+  BoundingSphere sphere = model->GetBoundingSphere();
+  for (const auto& vertex : vertices) {
+    double distance2 = 0.0;
+    for (int k = 0; k < 3; k++) {
+      EXPECT_LE(box.min[k], vertex[k] + 1e-9);
+      EXPECT_GE(box.max[k], vertex[k] - 1e-9);
+      distance2 += pow(vertex[k] - sphere.center[k], 2);
+    }
+    EXPECT_LE(sqrt(distance2), sphere.radius + 1e-9);
+  }
+  EXPECT_NEAR(sphere.center[0], 0.0, 1e-9);
+  EXPECT_NEAR(sphere.radius, 5.0, 1e-9);
+
+  // После переноса радиус считается проходом по вершинам.
+  model->MoveModel(1.0, 'x');
+  model->ScaleModelToFit(1.0);
+  max_distance = 0.0;
+  for (const auto& vertex : Rows(model->GetVertices())) {
+    max_distance = std::max(max_distance, sqrt(vertex[0] * vertex[0] +
+                                                vertex[1] * vertex[1] +
+                                                vertex[2] * vertex[2]));
+  }
+  EXPECT_NEAR(max_distance, 1.0, 1e-12);
+}
+
+TEST_F(ModelTest, CompactVertexStorage) {
+  std::string file_path = WriteGridObj("compact_grid.obj", 40);
+  Model reference;
+  reference.LoadModelData(file_path);
+  reference.RotateModel(0.4, 'x');
+  reference.ApplyRotation();
+  reference.NormalizeModel(1.0);
+  for (VertexStorage storage :
+       {VertexStorage::kFloat, VertexStorage::kQuantized}) {
+    Model compact_model;
+    compact_model.SetVertexStorage(storage);
+    compact_model.LoadModelData(file_path);
+    const CompactVertices& compact = compact_model.GetCompactVertices();
+    ASSERT_EQ(compact.size(), reference.GetSourceVertices().size());
+    EXPECT_EQ(compact_model.GetBytesPerVertex(),
+              storage == VertexStorage::kFloat ? 12U : 6U);
+    double error = compact_model.GetQuantizationError();
+    EXPECT_GT(error, 0.0);
+    // Шаг сетки по x — 4.875 / 32767, ошибка не больше половины шага.
+    EXPECT_LE(error, storage == VertexStorage::kFloat ? 1e-6 : 1e-4);
+
+    const auto source = Rows(reference.GetSourceVertices());
+    const auto decoded = Rows(compact_model.GetSourceVertices());
+    for (size_t i = 0; i < source.size(); ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        EXPECT_NEAR(decoded[i][j], source[i][j], error * (1 + 1e-9));
+      }
+    }
+
+    compact_model.RotateModel(0.4, 'x');
+    compact_model.ApplyRotation();
+    compact_model.NormalizeModel(1.0);
+    const auto expected = Rows(reference.GetVertices());
+    const auto vertices = Rows(compact_model.GetVertices());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        EXPECT_NEAR(vertices[i][j], expected[i][j], 1e-3);
+      }
+    }
+  }
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, CommandJournalUndoRedo) {
+  model->ParseModelData("obj/pyramid.obj");
+  const auto source = Rows(model->GetVertices());
+  CommandJournal journal;
+  journal.Execute(std::make_unique<RotateCommand>(model, 0.5, 'X'));
+  journal.Execute(std::make_unique<MoveCommand>(model, 2.0, 'y'));
+  journal.Execute(std::make_unique<CenterCommand>(model));
+  journal.Execute(std::make_unique<ScaleCommand>(model, 3.0));
+  const auto transformed = Rows(model->GetVertices());
+
+  Model expected;
+  expected.ParseModelData("obj/pyramid.obj");
+  expected.RotateModel(0.5, 'X');
+  expected.ApplyRotation();
+  expected.MoveModel(2.0, 'y');
+  expected.CenterModel();
+  expected.ScaleModelToFit(3.0);
+  const auto reference = Rows(expected.GetVertices());
+
+  auto expect_near = [](const std::vector<std::vector<double>>& a,
+                        const std::vector<std::vector<double>>& b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        EXPECT_NEAR(a[i][j], b[i][j], 1e-9);
+      }
+    }
+  };
+  expect_near(transformed, reference);
+
+  while (journal.Undo()) {
+  }
+  EXPECT_FALSE(journal.CanUndo());
+  expect_near(Rows(model->GetVertices()), source);
+  while (journal.Redo()) {
+  }
+  expect_near(Rows(model->GetVertices()), reference);
+
+  // Повороты мышью сливаются в одну запись, новая команда очищает повтор.
+  journal.Undo();
+  const auto centered = Rows(model->GetVertices());
+  journal.BeginCoalescing();
+  for (int i = 0; i < 50; i++) {
+    journal.Execute(std::make_unique<DragCommand>(model, 0.01, 0.02));
+  }
+  EXPECT_FALSE(journal.CanRedo());
+  EXPECT_EQ(journal.Size(), 4U);
+  const auto dragged = Rows(model->GetVertices());
+  // Сдвиг кнопкой во время поворота мышью остается отдельной записью
+  journal.Execute(std::make_unique<MoveCommand>(model, 0.5, 'z'));
+  journal.Execute(std::make_unique<DragCommand>(model, 0.01, 0.02));
+  journal.EndCoalescing();
+  EXPECT_EQ(journal.Size(), 6U);
+  journal.Undo();
+  journal.Undo();
+  expect_near(Rows(model->GetVertices()), dragged);
+  journal.Undo();
+  expect_near(Rows(model->GetVertices()), centered);
+}
+
+TEST_F(ModelTest, UniqueEdges) {
+  model->ParseModelData("obj/cube.obj");
+  // 12 ребер куба и 6 диагоналей треугольников.
+  EXPECT_EQ(model->GetEdgeCount(), 18);
+  const std::vector<int>& edges = model->GetEdges();
+  std::set<std::pair<int, int>> seen;
+  for (std::size_t i = 0; i < edges.size(); i += 2) {
+    EXPECT_LT(edges[i], edges[i + 1]);
+    EXPECT_TRUE(seen.insert({edges[i], edges[i + 1]}).second);
+  }
+  for (const auto facet : model->GetFacets()) {
+    for (std::size_t i = 0; i < facet.size(); i++) {
+      int a = facet[i];
+      int b = facet[(i + 1) % facet.size()];
+      EXPECT_EQ(seen.count({std::min(a, b), std::max(a, b)}), 1U);
+    }
+  }
+
+  std::string file_path = WriteGridObj("edges_grid.obj", 300);
+  Model serial_model;
+  serial_model.SetLoadThreads(1);
+  serial_model.LoadModelData(file_path);
+  model->SetLoadThreads(4);
+  model->LoadModelData(file_path);
+  EXPECT_EQ(model->GetEdges(), serial_model.GetEdges());
+  std::set<std::pair<int, int>> grid_edges;
+  for (const auto facet : model->GetFacets()) {
+    for (std::size_t i = 0; i < facet.size(); i++) {
+      int a = facet[i];
+      int b = facet[(i + 1) % facet.size()];
+      if (a != b) {
+        grid_edges.insert({std::min(a, b), std::max(a, b)});
+      }
+    }
+  }
+  EXPECT_EQ(static_cast<std::size_t>(model->GetEdgeCount()),
+            grid_edges.size());
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, AdjacencyIndex) {
+  model->ParseModelData("obj/cube.obj");
+  EXPECT_FALSE(model->AdjacencyBuilt());
+  const Adjacency& adjacency = model->GetAdjacency();
+  ASSERT_EQ(adjacency.VertexCount(), 8U);
+  ASSERT_EQ(adjacency.FacetCount(), 12U);
+  const FacetList& facets = model->GetFacets();
+  for (std::size_t v = 0; v < adjacency.VertexCount(); v++) {
+    std::vector<int> expected;
+    for (std::size_t f = 0; f < facets.size(); f++) {
+      const auto facet = ToVector(facets[f]);
+      if (std::find(facet.begin(), facet.end(), v) != facet.end()) {
+        expected.push_back(static_cast<int>(f));
+      }
+    }
+    EXPECT_EQ(ToVector(adjacency.FacetsOf(v)), expected);
+  }
+  // У каждого треугольника замкнутого куба три соседа по ребрам.
+  for (std::size_t f = 0; f < adjacency.FacetCount(); f++) {
+    EXPECT_EQ(adjacency.NeighborsOf(f).size(), 3U);
+  }
+  EXPECT_GT(adjacency.Stats().bytes, 0U);
+
+  // Четырехугольник a b b c: через вершину b соседом не становится
+  FacetList welded;
+  welded.Assign({0, 1, 1, 2, 1, 3, 4, 0, 1, 5}, {0, 4, 7, 10});
+  Adjacency welded_adjacency = Adjacency::Build(welded, 6, nullptr);
+  EXPECT_EQ(ToVector(welded_adjacency.NeighborsOf(0)), (std::vector<int>{2}));
+  EXPECT_TRUE(welded_adjacency.NeighborsOf(1).empty());
+  EXPECT_EQ(ToVector(welded_adjacency.NeighborsOf(2)), (std::vector<int>{0}));
+
+  model->MoveModel(1.0, 'x');
+  EXPECT_TRUE(model->AdjacencyBuilt());
+
+  std::string file_path = WriteGridObj("adjacency_grid.obj", 300);
+  Model serial_model;
+  serial_model.SetLoadThreads(1);
+  serial_model.SetAdjacencyEnabled(true);
+  serial_model.LoadModelData(file_path);
+  EXPECT_TRUE(serial_model.AdjacencyBuilt());
+  model->SetLoadThreads(4);
+  model->LoadModelData(file_path);
+  EXPECT_FALSE(model->AdjacencyBuilt());
+  const Adjacency& parallel = model->GetAdjacency();
+  const Adjacency& serial = serial_model.GetAdjacency();
+  ASSERT_EQ(parallel.FacetCount(), serial.FacetCount());
+  for (std::size_t f = 0; f < parallel.FacetCount(); f++) {
+    ASSERT_EQ(ToVector(parallel.NeighborsOf(f)),
+              ToVector(serial.NeighborsOf(f)));
+  }
+  for (std::size_t v = 0; v < parallel.VertexCount(); v++) {
+    ASSERT_EQ(ToVector(parallel.FacetsOf(v)), ToVector(serial.FacetsOf(v)));
+  }
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ModelTest, GeometryVersion) {
+  std::uint64_t empty = model->GetGeometryVersion();
+  model->ParseModelData("obj/cube.obj");
+  std::uint64_t loaded = model->GetGeometryVersion();
+  EXPECT_NE(loaded, empty);
+  model->RotateModel(0.5, 'x');
+  model->MoveModel(1.0, 'y');
+  model->NormalizeModel(1.0);
+  model->GetVertices();
+  EXPECT_EQ(model->GetGeometryVersion(), loaded);
+
+  std::vector<double> coords(model->GetSourceVertices().Coords().begin(),
+                             model->GetSourceVertices().Coords().end());
+  model->SetVertices(coords);
+  EXPECT_NE(model->GetGeometryVersion(), loaded);
+
+  // Другая модель, загруженная из того же файла, получает свою версию.
+  Model other;
+  other.ParseModelData("obj/cube.obj");
+  EXPECT_NE(other.GetGeometryVersion(), model->GetGeometryVersion());
+  std::uint64_t other_version = other.GetGeometryVersion();
+  *model = std::move(other);
+  EXPECT_EQ(model->GetGeometryVersion(), other_version);
+}
+
+TEST_F(ModelTest, ShuffledEdges) {
+  std::string file_path = WriteGridObj("shuffled_grid.obj", 40);
+  model->LoadModelData(file_path);
+  std::remove(file_path.c_str());
+  const std::vector<int>& edges = model->GetEdges();
+  const std::vector<int>& shuffled = model->GetShuffledEdges();
+  ASSERT_EQ(shuffled.size(), edges.size());
+  std::set<std::pair<int, int>> expected;
+  std::set<std::pair<int, int>> actual;
+  for (std::size_t i = 0; i < edges.size(); i += 2) {
+    expected.emplace(edges[i], edges[i + 1]);
+    actual.emplace(shuffled[i], shuffled[i + 1]);
+  }
+  EXPECT_EQ(actual, expected);
+  EXPECT_NE(shuffled, edges);
+  // Выборка строится один раз и переживает преобразования.
+  const int* data = shuffled.data();
+  model->RotateModel(0.3, 'z');
+  EXPECT_EQ(model->GetShuffledEdges().data(), data);
+  model->ParseModelData("obj/cube.obj");
+  EXPECT_EQ(model->GetShuffledEdges().size(), model->GetEdges().size());
+}
+
+TEST_F(ModelTest, LodChain) {
+  std::string file_path = WriteGridObj("lod_grid.obj", 60);
+  model->LoadModelData(file_path);
+  std::remove(file_path.c_str());
+  VertexBuffer source = model->GetSourceVertices();
+  BoundingBox box = model->GetBoundingBox();
+  LodTask task = model->PrepareLods();
+  LodChain chain = task();
+  ASSERT_EQ(chain.levels.size(), 3U);
+  std::size_t previous = static_cast<std::size_t>(model->GetFacetCount());
+  const double ratios[3] = {0.5, 0.25, 0.1};
+  for (std::size_t i = 0; i < chain.levels.size(); i++) {
+    const LodLevel& level = chain.levels[i];
+    std::size_t count = level.facets.size();
+    EXPECT_LE(count, static_cast<std::size_t>(
+                         ratios[i] * model->GetFacetCount() + 1));
+    EXPECT_GT(count, 0U);
+    EXPECT_LT(count, previous);
+    previous = count;
+    ASSERT_FALSE(level.edges.empty());
+    for (int index : level.edges) {
+      ASSERT_GE(index, 0);
+      ASSERT_LT(static_cast<std::size_t>(index), level.vertices.size());
+    }
+    // Вершины ставятся на стягиваемые ребра и не выходят за исходную рамку.
+    for (std::size_t v = 0; v < level.vertices.size(); v++) {
+      for (int axis = 0; axis < 3; axis++) {
+        EXPECT_GE(level.vertices[v][axis], box.min[axis] - 1e-9);
+        EXPECT_LE(level.vertices[v][axis], box.max[axis] + 1e-9);
+      }
+    }
+  }
+  EXPECT_TRUE(model->InstallLods(chain));
+  EXPECT_EQ(model->GetLods().size(), 3U);
+  EXPECT_EQ(model->GetSourceVertices(), source);
+  // Преобразования уровни не сбрасывают, замена вершин — сбрасывает.
+  model->RotateModel(0.5, 'y');
+  EXPECT_EQ(model->GetLods().size(), 3U);
+  model->SetVertices(std::vector<double>(source.Coords().begin(),
+                                         source.Coords().end()));
+  EXPECT_TRUE(model->GetLods().empty());
+  EXPECT_FALSE(model->InstallLods(chain));
+
+  // Сжатые вершины раскодируются уже в задаче упрощения.
+  file_path = WriteGridObj("lod_grid.obj", 60);
+  Model quantized;
+  quantized.SetVertexStorage(VertexStorage::kQuantized);
+  quantized.LoadModelData(file_path);
+  std::remove(file_path.c_str());
+  LodChain compact_chain = quantized.PrepareLods()();
+  ASSERT_EQ(compact_chain.levels.size(), 3U);
+  double tolerance = quantized.GetQuantizationError() + 1e-9;
+  for (const LodLevel& level : compact_chain.levels) {
+    for (std::size_t v = 0; v < level.vertices.size(); v++) {
+      for (int axis = 0; axis < 3; axis++) {
+        EXPECT_GE(level.vertices[v][axis], box.min[axis] - tolerance);
+        EXPECT_LE(level.vertices[v][axis], box.max[axis] + tolerance);
+      }
+    }
+  }
+
+  std::atomic<bool> cancel(true);
+  model->SetLodRatios({0.5, 0.01});
+  EXPECT_TRUE(model->PrepareLods(&cancel)().levels.size() < 2);
+}
+
 TEST_F(ModelTest, CenterModelEmpty) {
   model->ClearData();
   EXPECT_THROW(model->CenterModel(), std::runtime_error);
@@ -54,11 +54,34 @@ MainWindow::MainWindow(s21::Controller *controller, QWidget *parent)
           SLOT(onVerRadioButtonClicked(bool)));
 
   // Для отображения вершин, граней и некоректного файла
-  connect(glWidget, &OpenGLWidget::CountVertexFacets, this,
-          &MainWindow::TransferVerticesFacets);
+  connect(glWidget, &OpenGLWidget::CountVertexEdges, this,
+          &MainWindow::TransferVerticesEdges);
   connect(glWidget, &OpenGLWidget::FileIncorrect, this,
           &MainWindow::TransferFileIncorrect);
 
+  // Для фоновой загрузки
+  load_progress = new QProgressBar(this);
+  load_progress->setRange(0, 100);
+  load_progress->hide();
+  cancel_load = new QPushButton("Отмена", this);
+  cancel_load->hide();
+  ui->statusbar->addPermanentWidget(load_progress);
+  ui->statusbar->addPermanentWidget(cancel_load);
+  connect(glWidget, &OpenGLWidget::LoadStarted, this,
+          &MainWindow::ShowLoadProgress);
+  connect(glWidget, &OpenGLWidget::LoadProgress, this,
+          &MainWindow::UpdateLoadProgress);
+  connect(glWidget, &OpenGLWidget::LoadFinished, this,
+          &MainWindow::HideLoadProgress);
+  connect(cancel_load, &QPushButton::clicked, glWidget,
+          &OpenGLWidget::CancelLoading);
+
+  // Отмена и повтор преобразований
+  connect(new QShortcut(QKeySequence("Ctrl+Z"), this), &QShortcut::activated,
+          this, &MainWindow::UndoTransform);
+  connect(new QShortcut(QKeySequence("Ctrl+Shift+Z"), this),
+          &QShortcut::activated, this, &MainWindow::RedoTransform);
+
   // Для допки сохранения в форматах
   connect(ui->pushButton_bmp, SIGNAL(clicked()), this,
           SLOT(onSaveBMPButtonClicked()));
@@ -118,8 +141,9 @@ void MainWindow::on_loadButton_clicked() {
 }
 
 void MainWindow::on_selectionFile_clicked() {
-  file_path = QFileDialog::getOpenFileName(this, "Выбрать файл", "",
-                                           "Wavefront OBJ файлы (*.obj)");
+  file_path = QFileDialog::getOpenFileName(
+      this, "Выбрать файл", "",
+      "Wavefront OBJ файлы (*.obj *.obj.gz *.obj.zst)");
   if (!file_path.isEmpty()) {
     if (open_file == 1 && (ui->label_file->text() != "File incorrect")) {
       glWidget->ClearContent();
@@ -130,6 +154,7 @@ void MainWindow::on_selectionFile_clicked() {
       obj_path = file_path;
       QString fileName = fileInfo.fileName();
       ui->label_file->setText(fileName);
+      pending_matrix.clear();
       emit fileSelected(file_path);
     } else {
       ui->label_file->setText("File doesn't exist");
@@ -235,15 +260,80 @@ void MainWindow::onColorButtonVerClicked() {
   }
 }
 
-void MainWindow::TransferVerticesFacets(int count_vertex, int count_facets) {
+void MainWindow::TransferVerticesEdges(int count_vertex, int count_edges) {
   ui->label_top->setText(QString::number(count_vertex));
-  ui->label_ribs->setText(QString::number(count_facets));
+  ui->label_ribs->setText(QString::number(count_edges));
 }
 
 void MainWindow::TransferFileIncorrect(QString error_message) {
   ui->label_file->setText(error_message);
 }
 
+void MainWindow::ShowLoadProgress() {
+  ui->statusbar->clearMessage();
+  load_progress->setValue(0);
+  load_progress->show();
+  cancel_load->show();
+}
+
+void MainWindow::UpdateLoadProgress(qint64 bytes_parsed, qint64 bytes_total) {
+  if (bytes_total > 0) {
+    load_progress->setValue(static_cast<int>(bytes_parsed * 100 / bytes_total));
+  }
+}
+
+void MainWindow::HideLoadProgress(bool success) {
+  load_progress->hide();
+  cancel_load->hide();
+  if (success) {
+    if (pending_matrix.size() == 16) {
+      std::array<double, 16> elements;
+      std::copy(pending_matrix.begin(), pending_matrix.end(),
+                elements.begin());
+      controller_->SetTransform(s21::Transform(elements));
+      glWidget->update();
+    }
+    const s21::LoadStats &stats = controller_->GetLoadStats();
+    const s21::CleanupStats &cleanup = controller_->GetCleanupStats();
+    QString message = QString("%1 MB за %2 с (%3 MB/s)%4")
+                          .arg(stats.bytes / 1e6, 0, 'f', 1)
+                          .arg(stats.seconds, 0, 'f', 2)
+                          .arg(stats.MegabytesPerSecond(), 0, 'f', 0)
+                          .arg(stats.from_cache ? ", из кэша" : "");
+    if (controller_->GetCompactVertices().Storage() !=
+        s21::VertexStorage::kDouble) {
+      message += QString(", %1 байт на вершину, погрешность %2")
+                     .arg(controller_->GetBytesPerVertex())
+                     .arg(controller_->GetQuantizationError(), 0, 'g', 3);
+    }
+    if (controller_->AdjacencyBuilt()) {
+      const s21::AdjacencyStats &adjacency = controller_->GetAdjacencyStats();
+      message += QString(", смежность %1 MB за %2 с")
+                     .arg(adjacency.bytes / 1e6, 0, 'f', 1)
+                     .arg(adjacency.seconds, 0, 'f', 2);
+    }
+    if (cleanup.removed_vertices > 0 || cleanup.removed_facets > 0) {
+      message += QString(", склеено вершин: %1, удалено граней: %2")
+                     .arg(cleanup.removed_vertices)
+                     .arg(cleanup.removed_facets);
+    }
+    ui->statusbar->showMessage(message);
+  }
+  pending_matrix.clear();
+}
+
+void MainWindow::UndoTransform() {
+  if (controller_->Undo()) {
+    glWidget->update();
+  }
+}
+
+void MainWindow::RedoTransform() {
+  if (controller_->Redo()) {
+    glWidget->update();
+  }
+}
+
 void MainWindow::ScaleModelFromSpinBox(double scale_factor) {
   try {
     glWidget->ScaleModelToFit(scale_factor);
@@ -409,32 +499,30 @@ void MainWindow::ClearAllFunc() {
   }
 }
 
-void MainWindow::saveMatrix(const std::vector<std::vector<double>> &matrix) {
+void MainWindow::saveMatrix(const s21::Transform &transform) {
   QStringList serializedMatrix;
-  for (const auto &row : matrix) {
-    QStringList rowItems;
-    for (const auto &value : row) {
-      rowItems.append(QString::number(value));
-    }
-    serializedMatrix.append(rowItems.join(","));
+  for (double element : transform.Elements()) {
+    serializedMatrix.append(QString::number(element, 'g', 17));
   }
-  settings_.setValue("matrix_3d", serializedMatrix.join(";"));
+  settings_.setValue("transform_3d", serializedMatrix.join(","));
+  settings_.remove("matrix_3d");
 }
 
-std::vector<std::vector<double>> MainWindow::loadMatrix() {
-  std::vector<std::vector<double>> matrix;
-  QString serializedData = settings_.value("matrix_3d").toString();
-  QStringList rows = serializedData.split(";");
-
-  for (const auto &rowStr : rows) {
-    QStringList rowItems = rowStr.split(",");
-    std::vector<double> row;
-    for (const auto &item : rowItems) {
-      row.push_back(item.toDouble());
-    }
-    matrix.push_back(row);
+// 16 элементов матрицы по столбцам; при другом количестве список пуст
+std::vector<double> MainWindow::loadMatrix() {
+  std::vector<double> elements;
+  QString serializedData = settings_.value("transform_3d").toString();
+  if (serializedData.isEmpty()) {
+    return elements;
+  }
+  QStringList items = serializedData.split(",");
+  if (items.size() != 16) {
+    return elements;
+  }
+  for (const auto &item : items) {
+    elements.push_back(item.toDouble());
   }
-  return matrix;
+  return elements;
 }
 
 void MainWindow::SetSaivedBackColor() {
@@ -485,7 +573,7 @@ void MainWindow::saveSettings() {
   settings_.setValue("zMove", ui->lineEdit_zMove->text());
 
   ui->doubleSpinBox_interval->setValue(1.00);
-  saveMatrix(controller_->GetMatrix3D());
+  saveMatrix(controller_->GetTransform());
   settings_.endGroup();
 }
 
@@ -503,8 +591,8 @@ void MainWindow::loadSettings() {
   }
   file_path = settings_.value("filePath", "").toString();
   obj_path = file_path;
+  pending_matrix = loadMatrix();
   emit fileSelected(file_path);
-  controller_->SetMatrix3D(loadMatrix());
   ui->label_file->setText(settings_.value("fileName").toString());
 
   ui->doubleSpinBox_scal->setValue(settings_.value("scale").toInt());
@@ -6,7 +6,10 @@
 #include <QDoubleSpinBox>
 #include <QFileDialog>
 #include <QMainWindow>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QSettings>
+#include <QShortcut>
 #include <QTimer>
 
 #include "openglwidget.h"
@@ -40,7 +43,7 @@ class MainWindow : public QMainWindow {
   void onSaveBMPButtonClicked();
   void onSaveJPEGButtonClicked();
   void onPushButtonGifClicked();
-  void TransferVerticesFacets(int count_vertex, int count_facets);
+  void TransferVerticesEdges(int count_vertex, int count_edges);
   void TransferFileIncorrect(QString error_message);
   void ScaleModelFromSpinBox(double scale_factor);
   void IntervalLines(double interval_value);
@@ -48,6 +51,11 @@ class MainWindow : public QMainWindow {
   void SizeVer(double size_ver);
   void TranslateProjectionType(bool is_check_projection);
   void ClearAllFunc();
+  void ShowLoadProgress();
+  void UpdateLoadProgress(qint64 bytes_parsed, qint64 bytes_total);
+  void HideLoadProgress(bool success);
+  void UndoTransform();
+  void RedoTransform();
 
  private:
   void saveSettings();
@@ -63,9 +71,12 @@ class MainWindow : public QMainWindow {
   QColor back_color;
   QColor color_line;
   QColor color_ver;
+  QProgressBar *load_progress;
+  QPushButton *cancel_load;
+  std::vector<double> pending_matrix;
 
-  std::vector<std::vector<double>> loadMatrix();
-  void saveMatrix(const std::vector<std::vector<double>> &matrix);
+  std::vector<double> loadMatrix();
+  void saveMatrix(const s21::Transform &transform);
 
  public slots:
   void onPushButtonRotateClicked();
@@ -1,5 +1,130 @@
 #include "openglwidget.h"
 
+#include <QVector2D>
+#include <QVector4D>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+// Уровень подробности выбирается так, чтобы на пиксель видимой площади
+// модели приходилось не меньше kFacetsPerPixel граней, и огрубляется, пока
+// кадр не укладывается в kFrameBudgetMs
+constexpr double kFacetsPerPixel = 0.5;
+constexpr double kFrameBudgetMs = 1000.0 / 30;
+// Во время поворота мышью кадр должен укладываться в kDragFrameMs, полная
+// модель возвращается через kSettleMs после отпускания кнопки
+constexpr double kDragFrameMs = 1000.0 / 60;
+constexpr int kSettleMs = 150;
+
+// Стили в шейдере: сплошной, штриховой для линий, круглый для точек
+enum Style { kSolid = 0, kDashed = 1, kRound = 2 };
+
+// Преобразования модели, камеры и проекции выполняются на видеокарте.
+const char *const kVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform float point_size;
+noperspective out float line_distance;
+void main() {
+  gl_Position = projection * view * model * vec4(position, 1.0);
+  gl_PointSize = point_size;
+  line_distance = 0.0;
+}
+)";
+
+// В core-профиле glLineWidth больше 1 недоступен, поэтому каждый отрезок
+// разворачивается в прямоугольник шириной line_width пикселей. Отрезок
+// сначала обрезается ближней плоскостью, иначе деление на w переворачивает
+// его концы. line_distance — расстояние в пикселях от начала отрезка.
+const char *const kLineGeometryShader = R"(
+#version 330 core
+layout(lines) in;
+layout(triangle_strip, max_vertices = 4) out;
+uniform vec2 viewport;
+uniform float line_width;
+noperspective out float line_distance;
+void main() {
+  vec4 start = gl_in[0].gl_Position;
+  vec4 end = gl_in[1].gl_Position;
+  float start_depth = start.z + start.w;
+  float end_depth = end.z + end.w;
+  if (start_depth < 0.0 && end_depth < 0.0) return;
+  if (start_depth < 0.0) {
+    start = mix(start, end, start_depth / (start_depth - end_depth));
+  } else if (end_depth < 0.0) {
+    end = mix(start, end, start_depth / (start_depth - end_depth));
+  }
+  vec2 half_viewport = viewport * 0.5;
+  vec2 from = start.xy / start.w * half_viewport;
+  vec2 to = end.xy / end.w * half_viewport;
+  float pixels = length(to - from);
+  vec2 direction = pixels > 0.0 ? (to - from) / pixels : vec2(1.0, 0.0);
+  vec2 offset = vec2(-direction.y, direction.x) * 0.5 *
+                max(line_width, 1.0) / half_viewport;
+  gl_Position = vec4(start.xy + offset * start.w, start.zw);
+  line_distance = 0.0;
+  EmitVertex();
+  gl_Position = vec4(start.xy - offset * start.w, start.zw);
+  line_distance = 0.0;
+  EmitVertex();
+  gl_Position = vec4(end.xy + offset * end.w, end.zw);
+  line_distance = pixels;
+  EmitVertex();
+  gl_Position = vec4(end.xy - offset * end.w, end.zw);
+  line_distance = pixels;
+  EmitVertex();
+  EndPrimitive();
+}
+)";
+
+// Штрих повторяет glLineStipple(interval, 0x0F0F): 4 * interval пикселей
+// линии, столько же пропуска
+const char *const kFragmentShader = R"(
+#version 330 core
+uniform vec4 color;
+uniform int style;
+uniform float dash_period;
+noperspective in float line_distance;
+out vec4 frag_color;
+void main() {
+  if (style == 1) {
+    if (fract(line_distance / dash_period) >= 0.5) discard;
+  } else if (style == 2) {
+    if (length(gl_PointCoord - vec2(0.5)) > 0.5) discard;
+  }
+  frag_color = color;
+}
+)";
+
+// Точки рисуются без геометрического шейдера, линии — через него
+bool BuildProgram(QOpenGLShaderProgram &program, bool lines) {
+  return program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                         kVertexShader) &&
+         (!lines || program.addShaderFromSourceCode(QOpenGLShader::Geometry,
+                                                    kLineGeometryShader)) &&
+         program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                         kFragmentShader) &&
+         program.link();
+}
+
+QMatrix4x4 ToMatrix(const s21::Transform &transform) {
+  QMatrix4x4 matrix;
+  for (int row = 0; row < 4; row++) {
+    for (int column = 0; column < 4; column++) {
+      matrix(row, column) = static_cast<float>(transform.At(row, column));
+    }
+  }
+  return matrix;
+}
+
+}  // namespace
+
 OpenGLWidget::OpenGLWidget(s21::Controller *controller, QWidget *parent)
     : QOpenGLWidget(parent),
       controller(controller),
@@ -9,6 +134,27 @@ OpenGLWidget::OpenGLWidget(s21::Controller *controller, QWidget *parent)
       line_color(Qt::gray),
       back_color(Qt::black) {
   setFixedSize(win_width, win_height);
+  connect(&load_watcher, &QFutureWatcher<LoadResult>::finished, this,
+          &OpenGLWidget::OnLoadFinished);
+  connect(&lod_watcher, &QFutureWatcher<s21::LodChain>::finished, this,
+          &OpenGLWidget::OnLodsBuilt);
+  settle_timer.setSingleShot(true);
+  settle_timer.setInterval(kSettleMs);
+  connect(&settle_timer, &QTimer::timeout, this, [this]() {
+    interacting = false;
+    update();
+  });
+}
+
+OpenGLWidget::~OpenGLWidget() {
+  CancelLoading();
+  CancelLodBuild();
+  load_watcher.waitForFinished();
+  lod_watcher.waitForFinished();
+  makeCurrent();
+  ReleaseGeometry();
+  frame_timer.destroy();
+  doneCurrent();
 }
 
 void OpenGLWidget::initializeGL() {
@@ -16,134 +162,557 @@ void OpenGLWidget::initializeGL() {
 
   glClearColor(back_color.redF(), back_color.greenF(), back_color.blueF(),
                1.0f);
+  // Если драйвер не принял шейдеры, рисовать нечем: текст ошибки уходит
+  // туда же, куда сообщения о неверном файле
+  program_ready =
+      BuildProgram(program, false) && BuildProgram(line_program, true);
+  if (!program_ready) {
+    QString log = program.log() + line_program.log();
+    qWarning("Shader program failed: %s", qPrintable(log));
+    emit FileIncorrect("Shader error: " + log);
+  }
+  // Размер точек задает шейдер
+  glEnable(GL_PROGRAM_POINT_SIZE);
+  // Без таймеров уровень выбирается только по размеру модели на экране
+  frame_timer.create();
 }
 
 void OpenGLWidget::resizeGL(int w, int h) { glViewport(0, 0, w, h); }
 
 void OpenGLWidget::paintGL() {
-  if (!file_loaded) {
+  ApplyPendingDrag();
+  if (!file_loaded && preview_coords.empty()) {
     return;
   }
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
-  if (use_dotted_line) {
-    glEnable(GL_LINE_STIPPLE);
-  } else {
-    glDisable(GL_LINE_STIPPLE);
+  if (!program_ready) {
+    return;
   }
-  if (use_dotted_ver == 1) {
-    glEnable(GL_POINT_SMOOTH);
-  } else {
-    glDisable(GL_POINT_SMOOTH);
+  for (QOpenGLShaderProgram *shader : {&line_program, &program}) {
+    shader->bind();
+    shader->setUniformValue("view", camera);
+    shader->setUniformValue("projection", projection);
+    shader->setUniformValue(
+        "viewport", QVector2D(width(), height()) * devicePixelRatioF());
+    // Множитель штриха ограничен как у glLineStipple
+    shader->setUniformValue(
+        "dash_period",
+        static_cast<float>(8.0 * std::clamp(std::floor(line_interval), 1.0,
+                                            256.0) *
+                           devicePixelRatioF()));
+    shader->setUniformValue("line_width",
+                            static_cast<float>(line_width *
+                                               devicePixelRatioF()));
+    shader->setUniformValue("point_size", static_cast<float>(point_size));
+  }
+  if (!file_loaded) {
+    DrawPreview();
+    program.release();
+    return;
+  }
+  if (uploaded_version != controller->GetGeometryVersion()) {
+    UploadGeometry();
+  }
+  if (lod_meshes.size() != controller->GetLods().size()) {
+    UploadLods();
+  }
+  if (frame_timer_pending && frame_timer.isResultAvailable()) {
+    frame_ms = frame_timer.waitForResult() / 1e6;
+    frame_timer_pending = false;
+    if (timed_indices > 0) {
+      ms_per_index = frame_ms / timed_indices;
+    }
+    if (!timed_interactive) {
+      AdjustLodBias();
+    }
+  }
+  bool timing = frame_timer.isCreated() && !frame_timer_pending;
+  if (timing) {
+    frame_timer.begin();
   }
-  if (use_dotted_ver == 2) {
-    glEnable(GL_TEXTURE_2D);
+  drawn_indices = 0;
+  // Вершины не пересчитываются: преобразование модели применяет шейдер
+  QMatrix4x4 model_matrix = ToMatrix(controller->GetTransform());
+  // Сжатые вершины передаются как есть, восстановление входит в матрицу
+  // полной модели; упрощенные уровни хранятся в обычных координатах
+  QMatrix4x4 full_matrix = model_matrix;
+  const s21::CompactVertices &compact = controller->GetCompactVertices();
+  if (!compact.empty()) {
+    full_matrix *= ToMatrix(compact.Dequantization());
+  }
+  if (interacting) {
+    DrawInteractive(model_matrix, full_matrix);
+  } else if (size_t level = ChooseLevel(); level > 0) {
+    GpuMesh &mesh = *lod_meshes[level - 1];
+    DrawGeometry(model_matrix, mesh, mesh.index_count);
   } else {
-    glDisable(GL_TEXTURE_2D);
+    DrawGeometry(full_matrix, model_mesh, model_mesh.index_count);
+  }
+  if (timing) {
+    frame_timer.end();
+    frame_timer_pending = true;
+    timed_indices = drawn_indices;
+    timed_interactive = interacting;
   }
+  program.release();
+  emit CountVertexEdges(controller->GetVertexCount(),
+                        controller->GetEdgeCount());
+}
+
+void OpenGLWidget::DrawGeometry(const QMatrix4x4 &model_matrix,
+                                GpuMesh &mesh, GLsizei index_count) {
+  QOpenGLVertexArrayObject::Binder binder(&mesh.vao);
+  // Квадратные точки рисуются как есть, у круглых отбрасываются углы
   if (use_dotted_ver != 0) {
-    glColor3f(point_color.redF(), point_color.greenF(), point_color.blueF());
-    glBegin(GL_POINTS);
-    const auto &matrix_3d = controller->GetMatrix3D();
-    for (size_t i = 1; i < matrix_3d.size(); i++) {
-      glVertex3dv(matrix_3d[i].data());
+    program.bind();
+    program.setUniformValue("model", model_matrix);
+    program.setUniformValue("color", point_color);
+    program.setUniformValue("style", use_dotted_ver == 1 ? kRound : kSolid);
+    if (mesh.sampled) {
+      glDrawElements(GL_POINTS, index_count, GL_UNSIGNED_INT, nullptr);
+    } else {
+      glDrawArrays(GL_POINTS, 0, mesh.vertex_count);
+    }
+  }
+  // Общие ребра граней рисуются один раз
+  line_program.bind();
+  line_program.setUniformValue("model", model_matrix);
+  line_program.setUniformValue("color", line_color);
+  line_program.setUniformValue("style", use_dotted_line ? kDashed : kSolid);
+  glDrawElements(GL_LINES, index_count, GL_UNSIGNED_INT, nullptr);
+  drawn_indices += index_count;
+}
+
+// Самый подробный из вариантов, который по измеренной скорости укладывается
+// в kDragFrameMs: полная модель, упрощенные уровни, затем начало случайной
+// выборки ребер нужной длины
+void OpenGLWidget::DrawInteractive(const QMatrix4x4 &model_matrix,
+                                   const QMatrix4x4 &full_matrix) {
+  double budget = ms_per_index > 0.0 ? kDragFrameMs / ms_per_index : 0.0;
+  if (!(budget > 0.0) || model_mesh.index_count <= budget) {
+    DrawGeometry(full_matrix, model_mesh, model_mesh.index_count);
+    return;
+  }
+  for (auto &mesh : lod_meshes) {
+    if (mesh->index_count <= budget) {
+      DrawGeometry(model_matrix, *mesh, mesh->index_count);
+      return;
     }
-    glEnd();
-  }
-  glColor3f(line_color.redF(), line_color.greenF(), line_color.blueF());
-  glBegin(GL_LINES);
-  for (const auto &facet : controller->GetPolygons()) {
-    for (size_t i = 0; i < facet.vertices.size(); ++i) {
-      int currentVertexIndex = facet.vertices[i];
-      int nextVertexIndex = facet.vertices[(i + 1) % facet.vertices.size()];
-      glVertex3dv(controller->GetMatrix3D()[currentVertexIndex].data());
-      glVertex3dv(controller->GetMatrix3D()[nextVertexIndex].data());
+  }
+  GLsizei count = std::max<GLsizei>(2, static_cast<GLsizei>(budget / 2) * 2);
+  DrawGeometry(full_matrix, sample_mesh,
+               std::min(count, sample_mesh.index_count));
+}
+
+// Уровень 0 — полная модель, уровень i — lod_meshes[i - 1]
+size_t OpenGLWidget::ChooseLevel() const {
+  const std::vector<s21::LodLevel> &lods = controller->GetLods();
+  if (lods.empty() || lod_meshes.size() != lods.size()) {
+    return 0;
+  }
+  // Радиус описанной сферы в пикселях после проекции
+  s21::BoundingSphere sphere = controller->GetBoundingSphere();
+  QVector4D center = projection * camera *
+                     QVector4D(static_cast<float>(sphere.center[0]),
+                               static_cast<float>(sphere.center[1]),
+                               static_cast<float>(sphere.center[2]), 1.0f);
+  double depth = std::fabs(center.w());
+  if (!(depth > 0.0)) {
+    return 0;
+  }
+  double pixels = sphere.radius * std::fabs(projection(1, 1)) / depth *
+                  height() * devicePixelRatioF() / 2;
+  double needed = kFacetsPerPixel * M_PI * pixels * pixels;
+  size_t level = 0;
+  for (size_t i = lods.size(); i > 0; i--) {
+    if (static_cast<double>(lods[i - 1].facets.size()) >= needed) {
+      level = i;
+      break;
+    }
+  }
+  return std::min(level + lod_bias, lods.size());
+}
+
+void OpenGLWidget::AdjustLodBias() {
+  if (frame_ms > kFrameBudgetMs && lod_bias < lod_meshes.size()) {
+    lod_bias++;
+  } else if (frame_ms < kFrameBudgetMs / 3 && lod_bias > 0) {
+    lod_bias--;
+  }
+}
+
+// Вершины загружаются в том формате, в каком их хранит модель; double
+// переводятся во float, точности которого хватает для отрисовки
+void OpenGLWidget::UploadGeometry() {
+  const s21::CompactVertices &compact = controller->GetCompactVertices();
+  // Индексы вершин неотрицательны и совпадают с GL_UNSIGNED_INT побитно
+  const std::vector<int> &edges = controller->GetEdges();
+  switch (compact.Storage()) {
+    case s21::VertexStorage::kFloat:
+      UploadMesh(model_mesh, QOpenGLBuffer::StaticDraw, GL_FLOAT,
+                 compact.Floats(), compact.size(), edges.data(),
+                 edges.size());
+      break;
+    case s21::VertexStorage::kQuantized:
+      UploadMesh(model_mesh, QOpenGLBuffer::StaticDraw, GL_SHORT,
+                 compact.Shorts(), compact.size(), edges.data(),
+                 edges.size());
+      break;
+    default: {
+      s21::Span<const double> coords =
+          controller->GetSourceVertices().Coords();
+      std::vector<float> floats(coords.begin(), coords.end());
+      UploadMesh(model_mesh, QOpenGLBuffer::StaticDraw, GL_FLOAT,
+                 floats.data(), floats.size() / 3, edges.data(),
+                 edges.size());
+      break;
     }
   }
-  glEnd();
-  glDisable(GL_LINE_STIPPLE);
-  emit CountVertexFacets(controller->GetVertexCount(),
-                         controller->GetFacetCount());
+  UploadSample();
+  // Уровни прежней геометрии больше не нужны
+  for (auto &mesh : lod_meshes) {
+    ReleaseMesh(*mesh);
+  }
+  lod_meshes.clear();
+  lod_bias = 0;
+  uploaded_version = controller->GetGeometryVersion();
+}
+
+// Выборка использует вершинный буфер полной модели, своим у нее остается
+// только порядок ребер
+void OpenGLWidget::UploadSample() {
+  if (!sample_mesh.vao.isCreated()) {
+    sample_mesh.vao.create();
+    sample_mesh.indices.create();
+    sample_mesh.indices.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    sample_mesh.sampled = true;
+  }
+  const std::vector<int> &shuffled = controller->GetShuffledEdges();
+  QOpenGLVertexArrayObject::Binder binder(&sample_mesh.vao);
+  model_mesh.vertices.bind();
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, model_mesh.type, GL_FALSE, 0, nullptr);
+  sample_mesh.indices.bind();
+  sample_mesh.indices.allocate(
+      shuffled.data(), static_cast<int>(shuffled.size() * sizeof(GLuint)));
+  sample_mesh.type = model_mesh.type;
+  sample_mesh.vertex_count = model_mesh.vertex_count;
+  sample_mesh.index_count = static_cast<GLsizei>(shuffled.size());
+}
+
+void OpenGLWidget::UploadLods() {
+  for (auto &mesh : lod_meshes) {
+    ReleaseMesh(*mesh);
+  }
+  lod_meshes.clear();
+  for (const s21::LodLevel &level : controller->GetLods()) {
+    s21::Span<const double> coords = level.vertices.Coords();
+    std::vector<float> floats(coords.begin(), coords.end());
+    lod_meshes.push_back(std::make_unique<GpuMesh>());
+    UploadMesh(*lod_meshes.back(), QOpenGLBuffer::StaticDraw, GL_FLOAT,
+               floats.data(), floats.size() / 3, level.edges.data(),
+               level.edges.size());
+  }
+}
+
+void OpenGLWidget::UploadMesh(GpuMesh &mesh,
+                              QOpenGLBuffer::UsagePattern usage, GLenum type,
+                              const void *coords, size_t vertex_count,
+                              const void *indices, size_t index_count) {
+  if (!mesh.vao.isCreated()) {
+    mesh.vao.create();
+    mesh.vertices.create();
+    mesh.indices.create();
+  }
+  mesh.vertices.setUsagePattern(usage);
+  mesh.indices.setUsagePattern(usage);
+  size_t component = type == GL_SHORT ? sizeof(std::int16_t) : sizeof(float);
+  // Привязка буферов запоминается в VAO
+  QOpenGLVertexArrayObject::Binder binder(&mesh.vao);
+  mesh.vertices.bind();
+  mesh.vertices.allocate(coords,
+                         static_cast<int>(3 * vertex_count * component));
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, type, GL_FALSE, 0, nullptr);
+  mesh.indices.bind();
+  mesh.indices.allocate(indices,
+                        static_cast<int>(index_count * sizeof(GLuint)));
+  mesh.type = type;
+  mesh.vertex_count = static_cast<GLsizei>(vertex_count);
+  mesh.index_count = static_cast<GLsizei>(index_count);
+}
+
+void OpenGLWidget::ReleaseMesh(GpuMesh &mesh) {
+  mesh.vertices.destroy();
+  mesh.indices.destroy();
+  mesh.vao.destroy();
+  mesh.vertex_count = 0;
+  mesh.index_count = 0;
+}
+
+void OpenGLWidget::ReleaseGeometry() {
+  ReleaseMesh(model_mesh);
+  ReleaseMesh(preview_mesh);
+  ReleaseMesh(sample_mesh);
+  for (auto &mesh : lod_meshes) {
+    ReleaseMesh(*mesh);
+  }
+  lod_meshes.clear();
+  uploaded_version = 0;
+}
+
+void OpenGLWidget::UploadPreview() {
+  std::vector<float> floats(preview_coords.begin(), preview_coords.end());
+  UploadMesh(preview_mesh, QOpenGLBuffer::DynamicDraw, GL_FLOAT,
+             floats.data(), floats.size() / 3, preview_lines.data(),
+             preview_lines.size());
+  preview_dirty = false;
 }
 
 void OpenGLWidget::LoadModelFile(const QString &file_path) {
-  try {
-    if (file_loaded) {
-      controller->ClearModelData();
-      update();
+  CancelLoading();
+  CancelLodBuild();
+  if (file_loaded) {
+    file_loaded = false;
+    controller->ClearModelData();
+    update();
+  }
+  ClearPreview();
+  // Разбор идет в фоне, готовая модель подменяется в OnLoadFinished
+  auto cancel = std::make_shared<std::atomic<bool>>(false);
+  load_cancel = cancel;
+  s21::LoadControl control;
+  control.cancel = cancel.get();
+  control.progress = [this, cancel](std::size_t done, std::size_t total) {
+    if (!cancel->load()) {
+      emit LoadProgress(static_cast<qint64>(done), static_cast<qint64>(total));
+    }
+  };
+  // Уже прочитанная геометрия показывается до конца загрузки
+  control.batch = [this, cancel](s21::LoadBatch &&batch) {
+    auto arrived = std::make_shared<s21::LoadBatch>(std::move(batch));
+    QMetaObject::invokeMethod(
+        this,
+        [this, arrived, cancel]() {
+          if (!cancel->load()) {
+            AppendPreview(*arrived);
+          }
+        },
+        Qt::QueuedConnection);
+  };
+  // Настройки снимаются здесь: текущую модель может подменить OnLoadFinished
+  // прежней загрузки, пока идет разбор
+  s21::LoadSettings settings = controller->GetLoadSettings();
+  std::string path = file_path.toStdString();
+  emit LoadStarted();
+  load_watcher.setFuture(QtConcurrent::run([settings, path, control, cancel]() {
+    LoadResult result;
+    try {
+      result.model = s21::Controller::PrepareModel(path, settings, control);
+    } catch (const s21::LoadCancelled &) {
+      result.cancelled = true;
+    } catch (const std::exception &) {
+      result.model.reset();
+    }
+    return result;
+  }));
+}
+
+void OpenGLWidget::CancelLoading() {
+  if (load_cancel) {
+    load_cancel->store(true);
+    load_cancel.reset();
+  }
+}
+
+void OpenGLWidget::OnLoadFinished() {
+  LoadResult result = load_watcher.result();
+  load_cancel.reset();
+  std::vector<PreviewStep> steps;
+  steps.swap(preview_steps);
+  ClearPreview();
+  if (result.model) {
+    controller->CommitModel(std::move(*result.model));
+    for (const auto &step : steps) {
+      if (step.rotate) {
+        controller->RotateModel(step.step, step.xyz);
+        controller->ApplyRotation();
+      } else {
+        controller->MoveModel(step.step, step.xyz);
+      }
     }
-    controller->LoadModel(file_path.toStdString());
-    controller->CenterModel();
-    ScaleModelToFit(1.0);
     file_loaded = true;
+    StartLodBuild();
     update();
-  } catch (const std::exception &e) {
+    emit LoadFinished(true);
+    return;
+  }
+  if (result.cancelled) {
+    emit FileIncorrect("Loading cancelled");
+  } else {
     emit FileIncorrect("File incorrect");
-    emit CountVertexFacets(0, 0);
   }
+  emit CountVertexEdges(0, 0);
+  emit LoadFinished(false);
+}
+
+// Упрощенные уровни строятся в фоне над копией геометрии и принимаются,
+// только если модель за это время не сменилась
+void OpenGLWidget::StartLodBuild() {
+  CancelLodBuild();
+  auto cancel = std::make_shared<std::atomic<bool>>(false);
+  lod_cancel = cancel;
+  s21::LodTask task = controller->PrepareLods(cancel.get());
+  lod_watcher.setFuture(
+      QtConcurrent::run([task, cancel]() { return task(); }));
+}
+
+void OpenGLWidget::CancelLodBuild() {
+  if (lod_cancel) {
+    lod_cancel->store(true);
+    lod_cancel.reset();
+  }
+}
+
+void OpenGLWidget::OnLodsBuilt() {
+  lod_cancel.reset();
+  if (controller->InstallLods(lod_watcher.result())) {
+    update();
+  }
+}
+
+void OpenGLWidget::AppendPreview(const s21::LoadBatch &batch) {
+  std::size_t first = preview_coords.size();
+  preview_coords.insert(preview_coords.end(), batch.coords.begin(),
+                        batch.coords.end());
+  for (std::size_t i = first; i < preview_coords.size(); i += 3) {
+    for (int axis = 0; axis < 3; axis++) {
+      double value = preview_coords[i + axis];
+      if (i == 0 || value < preview_min[axis]) {
+        preview_min[axis] = value;
+      }
+      if (i == 0 || value > preview_max[axis]) {
+        preview_max[axis] = value;
+      }
+    }
+  }
+  std::size_t offset = 0;
+  for (int size : batch.facet_sizes) {
+    for (int i = 0; i < size; i++) {
+      preview_lines.push_back(batch.indices[offset + i]);
+      preview_lines.push_back(batch.indices[offset + (i + 1) % size]);
+    }
+    offset += size;
+  }
+  preview_dirty = true;
+  emit CountVertexEdges(static_cast<int>(preview_coords.size() / 3),
+                        static_cast<int>(preview_lines.size() / 2));
+  update();
+}
+
+void OpenGLWidget::DrawPreview() {
+  if (preview_dirty) {
+    UploadPreview();
+  }
+  double radius = 0.0;
+  for (int axis = 0; axis < 3; axis++) {
+    double half = (preview_max[axis] - preview_min[axis]) / 2;
+    radius += half * half;
+  }
+  radius = sqrt(radius);
+  QMatrix4x4 model_matrix = preview_transform;
+  if (radius > 0.0) {
+    model_matrix.scale(static_cast<float>(1.0 / radius));
+  }
+  model_matrix.translate(
+      static_cast<float>(-(preview_min[0] + preview_max[0]) / 2),
+      static_cast<float>(-(preview_min[1] + preview_max[1]) / 2),
+      static_cast<float>(-(preview_min[2] + preview_max[2]) / 2));
+  DrawGeometry(model_matrix, preview_mesh, preview_mesh.index_count);
+}
+
+void OpenGLWidget::ClearPreview() {
+  preview_coords.clear();
+  preview_coords.shrink_to_fit();
+  preview_lines.clear();
+  preview_lines.shrink_to_fit();
+  preview_dirty = true;
+  preview_transform.setToIdentity();
+  preview_steps.clear();
+}
+
+void OpenGLWidget::AddPreviewStep(bool rotate, double step, char xyz) {
+  char axis = static_cast<char>(tolower(xyz));
+  if (axis != 'x' && axis != 'y' && axis != 'z') {
+    return;
+  }
+  preview_transform = PreviewStepMatrix(rotate, step, xyz) * preview_transform;
+  preview_steps.push_back({rotate, step, xyz});
+  update();
+}
+
+QMatrix4x4 OpenGLWidget::PreviewStepMatrix(bool rotate, double step,
+                                           char xyz) {
+  double sign = isupper(xyz) ? -1.0 : 1.0;
+  char axis = static_cast<char>(tolower(xyz));
+  QVector3D direction(axis == 'x', axis == 'y', axis == 'z');
+  QMatrix4x4 step_matrix;
+  if (rotate) {
+    step_matrix.rotate(static_cast<float>(sign * step * 180.0 / M_PI),
+                       direction);
+  } else {
+    step_matrix.translate(static_cast<float>(sign * step) * direction);
+  }
+  return step_matrix;
 }
 
 void OpenGLWidget::SetProjectionType(int value) {
-  makeCurrent();
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
+  // Смена проекции меняет только матрицы, вершины не перезагружаются
+  projection.setToIdentity();
   if (value == 0) {
     // Центральная
     float fov = 60 * M_PI / 180;
     float heapHeight = win_height / (2 * tan(fov / 2));
-    glFrustum(-win_width / 12, win_width / 12, -win_height / 12,
-              win_height / 12, heapHeight, 2);
+    projection.frustum(-win_width / 12, win_width / 12, -win_height / 12,
+                       win_height / 12, heapHeight, 2);
   } else if (value == 1) {
     // Параллельная
-    glOrtho(-win_width / win_width, win_width / win_width,
-            -win_height / win_height, win_height / win_height, -100, 100);
+    projection.ortho(-win_width / win_width, win_width / win_width,
+                     -win_height / win_height, win_height / win_height, -100,
+                     100);
   }
-  glTranslatef(0.0, 0.0, -10.0);
-  glMatrixMode(GL_MODELVIEW);
-  doneCurrent();
+  camera.setToIdentity();
+  camera.translate(0.0f, 0.0f, -10.0f);
   update();
 }
 
 void OpenGLWidget::ScaleModelToFit(double scale_factor) {
-  makeCurrent();
   controller->ScaleModelToFit(scale_factor);
-  doneCurrent();
   update();
 }
 
 void OpenGLWidget::EditIntervalLines(double interval_value) {
-  makeCurrent();
-  glLineStipple(interval_value, 0x0F0F);
-  doneCurrent();
+  line_interval = interval_value;
   update();
 }
 
 void OpenGLWidget::EditThicknessLines(double thickness_value) {
-  makeCurrent();
-  glLineWidth(thickness_value);
-  doneCurrent();
+  line_width = thickness_value;
   update();
 }
 
 void OpenGLWidget::SetLineStyle(bool line) {
-  makeCurrent();
   use_dotted_line = line;
-  doneCurrent();
   update();
 }
 
 void OpenGLWidget::VerStyle(int dottedVer) {
-  makeCurrent();
   use_dotted_ver = dottedVer;
-  doneCurrent();
   update();
 }
 
 void OpenGLWidget::EditSizeVer(double size_ver) {
-  makeCurrent();
-  glPointSize(size_ver);
-  doneCurrent();
+  point_size = size_ver;
   update();
 }
 
@@ -165,17 +734,20 @@ void OpenGLWidget::SetColorLineVer(const QColor &color, bool type) {
 }
 
 void OpenGLWidget::RotateModel(double step, char xyz) {
-  makeCurrent();
+  if (load_cancel) {
+    AddPreviewStep(true, step, xyz);
+    return;
+  }
   controller->RotateModel(step, xyz);
-  controller->ApplyRotation();
-  doneCurrent();
   update();
 }
 
 void OpenGLWidget::MoveModel(double step, char xyz) {
-  makeCurrent();
+  if (load_cancel) {
+    AddPreviewStep(false, step, xyz);
+    return;
+  }
   controller->MoveModel(step, xyz);
-  doneCurrent();
   update();
 }
 
@@ -186,18 +758,53 @@ void OpenGLWidget::SaveImage(const QString &filename) {
 
 void OpenGLWidget::mousePressEvent(QMouseEvent *event) {
   last_mouse_pos = event->pos();
+  // Весь поворот мышью отменяется одним Ctrl+Z
+  controller->BeginDrag();
+  settle_timer.stop();
+  interacting = true;
+}
+
+void OpenGLWidget::mouseReleaseEvent(QMouseEvent *) {
+  controller->EndDrag();
+  settle_timer.start();
 }
 
+// Смещения мыши копятся и применяются один раз за кадр в paintGL, так что
+// число пересчетов ограничено частотой кадров, а не частотой событий
 void OpenGLWidget::mouseMoveEvent(QMouseEvent *event) {
   int dx = event->x() - last_mouse_pos.x();
   int dy = event->y() - last_mouse_pos.y();
-  RotateModel(dy * rotation_speed, 'x');
-  RotateModel(dx * rotation_speed, 'y');
+  pending_drag_x += dy * rotation_speed;
+  pending_drag_y += dx * rotation_speed;
   last_mouse_pos = event->pos();
   update();
 }
 
+void OpenGLWidget::ApplyPendingDrag() {
+  const double steps[2] = {pending_drag_x, pending_drag_y};
+  const char axes[2] = {'x', 'y'};
+  pending_drag_x = 0.0;
+  pending_drag_y = 0.0;
+  if (steps[0] == 0.0 && steps[1] == 0.0) {
+    return;
+  }
+  if (load_cancel) {
+    for (int i = 0; i < 2; i++) {
+      if (steps[i] != 0.0) {
+        preview_transform = PreviewStepMatrix(true, steps[i], axes[i]) *
+                            preview_transform;
+        preview_steps.push_back({true, steps[i], axes[i]});
+      }
+    }
+  } else if (file_loaded) {
+    controller->DragModel(steps[0], steps[1]);
+  }
+}
+
 void OpenGLWidget::ClearContent() {
+  CancelLoading();
+  CancelLodBuild();
+  ClearPreview();
   file_loaded = false;
   controller->ClearModelData();
   update();
@@ -1,10 +1,21 @@
 #ifndef OPENGLWIDGET_H
 #define OPENGLWIDGET_H
 
+#include <QFutureWatcher>
 #include <QImageWriter>
+#include <QMatrix4x4>
 #include <QMouseEvent>
+#include <QOpenGLBuffer>
 #include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTimerQuery>
+#include <QOpenGLVertexArrayObject>
 #include <QOpenGLWidget>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "../controller/controller.h"
 
@@ -13,6 +24,7 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
 
  public:
   OpenGLWidget(s21::Controller *controller, QWidget *parent = nullptr);
+  ~OpenGLWidget();
   void RotateModel(double step, char xyz);
   void MoveModel(double step, char xyz);
   void EditIntervalLines(double scale_factor);
@@ -25,6 +37,7 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
 
  public slots:
   void LoadModelFile(const QString &file_path);
+  void CancelLoading();
   void ScaleModelToFit(double scale_factor);
   void SetBackgroundColor(const QColor &color);
   void SetColorLineVer(const QColor &color, bool type);
@@ -38,8 +51,58 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
   void paintGL() override;
   void mousePressEvent(QMouseEvent *event) override;
   void mouseMoveEvent(QMouseEvent *event) override;
+  void mouseReleaseEvent(QMouseEvent *event) override;
+
+ private slots:
+  void OnLoadFinished();
+  void OnLodsBuilt();
 
  private:
+  struct LoadResult {
+    std::shared_ptr<s21::Model> model;
+    bool cancelled = false;
+  };
+  struct PreviewStep {
+    bool rotate;
+    double step;
+    char xyz;
+  };
+  // Буферы одной сетки в памяти видеокарты
+  struct GpuMesh {
+    QOpenGLBuffer vertices{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer indices{QOpenGLBuffer::IndexBuffer};
+    QOpenGLVertexArrayObject vao;
+    GLenum type = GL_FLOAT;
+    GLsizei vertex_count = 0;
+    GLsizei index_count = 0;
+    // Выборка ребер: точки берутся из концов выбранных ребер
+    bool sampled = false;
+  };
+
+  void AppendPreview(const s21::LoadBatch &batch);
+  void DrawPreview();
+  void ClearPreview();
+  void AddPreviewStep(bool rotate, double step, char xyz);
+  static QMatrix4x4 PreviewStepMatrix(bool rotate, double step, char xyz);
+  void ApplyPendingDrag();
+  void UploadGeometry();
+  void UploadLods();
+  void UploadSample();
+  void UploadPreview();
+  void UploadMesh(GpuMesh &mesh, QOpenGLBuffer::UsagePattern usage,
+                  GLenum type, const void *coords, size_t vertex_count,
+                  const void *indices, size_t index_count);
+  void ReleaseMesh(GpuMesh &mesh);
+  void ReleaseGeometry();
+  void DrawGeometry(const QMatrix4x4 &model_matrix, GpuMesh &mesh,
+                    GLsizei index_count);
+  void DrawInteractive(const QMatrix4x4 &model_matrix,
+                       const QMatrix4x4 &full_matrix);
+  size_t ChooseLevel() const;
+  void AdjustLodBias();
+  void StartLodBuild();
+  void CancelLodBuild();
+
   s21::Controller *controller;
   bool file_loaded;
   float scale;
@@ -48,13 +111,59 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
   QColor back_color;
   QPoint last_mouse_pos;
   double rotation_speed = 0.01;
-  bool use_dotted_line;
+  double pending_drag_x = 0.0;
+  double pending_drag_y = 0.0;
+  bool use_dotted_line = false;
+  double line_interval = 1.0;
+  double line_width = 1.0;
+  double point_size = 1.0;
   int use_dotted_ver = 0;
   int win_height = 540, win_width = 650;
+  QFutureWatcher<LoadResult> load_watcher;
+  std::shared_ptr<std::atomic<bool>> load_cancel;
+  std::vector<double> preview_coords;
+  std::vector<GLuint> preview_lines;
+  double preview_min[3] = {0.0, 0.0, 0.0};
+  double preview_max[3] = {0.0, 0.0, 0.0};
+  QMatrix4x4 preview_transform;
+  std::vector<PreviewStep> preview_steps;
+  bool preview_dirty = false;
+  // Точки рисуются program, линии — line_program с геометрическим шейдером
+  QOpenGLShaderProgram program;
+  QOpenGLShaderProgram line_program;
+  bool program_ready = false;
+  QMatrix4x4 projection;
+  QMatrix4x4 camera;
+  // Геометрия модели в памяти видеокарты, перезагружается при смене версии
+  GpuMesh model_mesh;
+  GpuMesh preview_mesh;
+  // Ребра полной модели в случайном порядке поверх ее вершинного буфера
+  GpuMesh sample_mesh;
+  // Упрощенные уровни от подробного к грубому
+  std::vector<std::unique_ptr<GpuMesh>> lod_meshes;
+  std::uint64_t uploaded_version = 0;
+  QFutureWatcher<s21::LodChain> lod_watcher;
+  std::shared_ptr<std::atomic<bool>> lod_cancel;
+  // Время отрисовки на видеокарте, результат читается кадром позже
+  QOpenGLTimerQuery frame_timer;
+  bool frame_timer_pending = false;
+  double frame_ms = 0.0;
+  size_t lod_bias = 0;
+  // Пока мышь держит модель, рисуется то, что укладывается в бюджет кадра;
+  // полная модель возвращается после паузы
+  bool interacting = false;
+  QTimer settle_timer;
+  GLsizei drawn_indices = 0;
+  GLsizei timed_indices = 0;
+  bool timed_interactive = false;
+  double ms_per_index = 0.0;
 
  signals:
-  void CountVertexFacets(int count_vertex, int count_facets);
+  void CountVertexEdges(int count_vertex, int count_edges);
   void FileIncorrect(QString error_message);
+  void LoadStarted();
+  void LoadProgress(qint64 bytes_parsed, qint64 bytes_total);
+  void LoadFinished(bool success);
 };
 
 #endif  // OPENGLWIDGET_H
@@ -1,4 +1,4 @@
-QT       += core gui opengl printsupport
+QT       += core gui opengl printsupport concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,17 +8,52 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+LIBS += -lz
+
+# Поддержка .obj.zst:
+#DEFINES += S21_HAVE_ZSTD
+#LIBS += -lzstd
+
 SOURCES += \
     ../controller/controller.cc \
+    ../model/adjacency.cc \
+    ../model/bounding_volume.cc \
+    ../model/compact_vertices.cc \
+    ../model/compressed_file.cc \
+    ../model/edge_list.cc \
+    ../model/lod.cc \
+    ../model/mesh_cache.cc \
+    ../model/mesh_cleanup.cc \
     ../model/model.cc \
+    ../model/obj_parser.cc \
+    ../model/parallel_for.cc \
+    ../model/thread_pool.cc \
+    ../model/transform.cc \
+    ../model/transform_kernel.cc \
     ../main.cpp \
     mainwindow.cpp \
     openglwidget.cpp \
 
 HEADERS += \
     ../controller/controller.h \
+    ../model/adjacency.h \
+    ../model/bounding_volume.h \
     ../model/command.h \
+    ../model/compact_vertices.h \
+    ../model/compressed_file.h \
+    ../model/edge_list.h \
+    ../model/facet_list.h \
+    ../model/lod.h \
+    ../model/mesh_cache.h \
+    ../model/mesh_cleanup.h \
     ../model/model.h \
+    ../model/obj_parser.h \
+    ../model/parallel_for.h \
+    ../model/span.h \
+    ../model/thread_pool.h \
+    ../model/transform.h \
+    ../model/transform_kernel.h \
+    ../model/vertex_buffer.h \
     mainwindow.h \
     openglwidget.h \
 